@@ -0,0 +1,91 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/batch_knn.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+constexpr std::size_t num_points = std::size_t(1) << 20;
+constexpr std::size_t num_queries = std::size_t(1) << 16;
+
+// Queries answered one at a time in arrival order, for comparison with
+// BM_FindKNearestBatch.
+void
+BM_FindKNearestQueries(benchmark::State& state)
+{
+    auto k = static_cast<std::size_t>(state.range(0));
+
+    auto points = bench::GenerateUniformPoints<Point>(num_points);
+    auto queries = bench::GenerateUniformPoints<Point>(num_queries, 7);
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+    for (auto _ : state)
+    {
+        for (auto const& query : queries)
+        {
+            auto knn = zorder_knn::FindKNearest<Point, 3>(points, query, k);
+            benchmark::DoNotOptimize(knn.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+// Queries answered in z-order by range(1) threads, including the time to
+// sort them.
+void
+BM_FindKNearestBatch(benchmark::State& state)
+{
+    auto k = static_cast<std::size_t>(state.range(0));
+    auto nthreads = static_cast<std::size_t>(state.range(1));
+
+    auto points = bench::GenerateUniformPoints<Point>(num_points);
+    auto queries = bench::GenerateUniformPoints<Point>(num_queries, 7);
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+    zorder_knn::ThreadPool pool(nthreads);
+    for (auto _ : state)
+    {
+        auto knn = zorder_knn::FindKNearestBatch<Point, 3>(pool, points,
+            queries, k);
+        benchmark::DoNotOptimize(knn.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+}
+
+BENCHMARK(BM_FindKNearestQueries)->ArgNames({ "k" })->Arg(8)->Arg(16)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_FindKNearestBatch)->ArgNames({ "k", "threads" })
+    ->Args({ 8, 1 })->Args({ 16, 1 })->Args({ 8, 4 })->Args({ 16, 4 })
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,104 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/block_file.hpp>
+#include <zorder_knn/sort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <array>
+
+#if defined(ZORDER_KNN_HAS_MMAP)
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+std::string
+WriteBenchBlockFile(std::size_t n, std::size_t block_size)
+{
+    auto points = bench::GenerateUniformPoints<Point>(n);
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+    std::string path = "zorder_knn_bench_blocks.bin";
+    zorder_knn::WriteBlockFile<Point, 3>(path, points.begin(), points.end(),
+        block_size);
+
+    return path;
+}
+
+void
+BM_BlockFileOpen(benchmark::State& state)
+{
+    auto path = WriteBenchBlockFile(state.range(0), 4096);
+
+    for (auto _ : state)
+    {
+        zorder_knn::BlockFileReader<Point, 3> reader(path);
+        benchmark::DoNotOptimize(reader.Data());
+    }
+
+    std::remove(path.c_str());
+}
+
+// Find the points within a cube of edge length range(2) among range(0)
+// points in [-100, 100]^3, stored in blocks of range(1) points.
+void
+BM_BlockFileBoxQuery(benchmark::State& state)
+{
+    auto path = WriteBenchBlockFile(state.range(0), state.range(1));
+    auto centers = bench::GenerateUniformPoints<Point>(1 << 10, 7);
+    auto r = 0.5f * static_cast<float>(state.range(2));
+
+    std::size_t i{0}, nfound{0};
+    {
+        zorder_knn::BlockFileReader<Point, 3> reader(path);
+        for (auto _ : state)
+        {
+            auto const& c = centers[i++ % centers.size()];
+            zorder_knn::Box<Point> box{ { { c[0] - r, c[1] - r, c[2] - r } },
+                { { c[0] + r, c[1] + r, c[2] + r } } };
+
+            reader.ForEachInBox(box, [&](std::size_t, Point const&) {
+                ++nfound;
+            });
+        }
+    }
+
+    std::remove(path.c_str());
+
+    state.counters["found"] = benchmark::Counter(static_cast<double>(nfound),
+        benchmark::Counter::kAvgIterations);
+}
+
+}
+
+BENCHMARK(BM_BlockFileOpen)->Arg(1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BlockFileBoxQuery)->ArgNames({ "n", "block", "edge" })
+    ->Args({ 1 << 22, 256, 10 })->Args({ 1 << 22, 4096, 10 })
+    ->Args({ 1 << 22, 256, 40 })->Unit(benchmark::kMicrosecond);
+
+#endif // ZORDER_KNN_HAS_MMAP
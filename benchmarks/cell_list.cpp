@@ -0,0 +1,150 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/cell_list.hpp>
+#include <zorder_knn/knn.hpp>
+#include <zorder_knn/radix_tree.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// Radius yielding about 32 neighbors per point for range(0) uniform
+// points within [-100, 100]^3.
+float
+Radius(benchmark::State const& state)
+{
+    auto n = static_cast<double>(state.range(0));
+    return static_cast<float>(std::cbrt(32.0 * 8e6 / (n * 4.18879)));
+}
+
+void
+BM_CellListBuild(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    zorder_knn::ThreadPool pool(1);
+
+    for (auto _ : state)
+    {
+        zorder_knn::CellList<Point, 3> cells(pool, points, Radius(state));
+        benchmark::DoNotOptimize(cells.Points().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Neighbor counts of all points, an SPH-like accumulation over all pairs.
+void
+BM_CellListPairs(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    zorder_knn::ThreadPool pool(1);
+    zorder_knn::CellList<Point, 3> cells(pool, points, Radius(state));
+
+    std::vector<std::size_t> counts(points.size());
+    for (auto _ : state)
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        cells.ForEachPair(pool, [&](std::size_t i, std::size_t) { ++counts[i]; });
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same by radius queries of the radix tree.
+void
+BM_RadixTreePairs(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    zorder_knn::RadixTree<Point, 3> tree(points, 1);
+    auto r = Radius(state);
+
+    std::vector<std::size_t> counts(points.size());
+    for (auto _ : state)
+    {
+        for (std::size_t i{0}; i < points.size(); ++i)
+        {
+            counts[i] = 0;
+            tree.ForEachWithin(points[i], r, [&](std::size_t j) { counts[i] += (i != j); });
+        }
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The 32 nearest neighbors of all points, which approximate the pairs.
+void
+BM_KnnGraphPairs(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto graph = zorder_knn::BuildKnnGraph<Point, 3>(points, 32);
+        benchmark::DoNotOptimize(graph.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+BM_BruteForcePairs(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    auto r = Radius(state);
+
+    std::vector<std::size_t> counts(points.size());
+    for (auto _ : state)
+    {
+        for (std::size_t i{0}; i < points.size(); ++i)
+        {
+            counts[i] = 0;
+            for (std::size_t j{0}; j < points.size(); ++j)
+            {
+                using zorder_knn::detail::SquaredDistance;
+                counts[i] += (i != j && SquaredDistance<Point, 3>(points[i], points[j]) <= r * r);
+            }
+        }
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(BM_CellListBuild)->Arg(1 << 14)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CellListPairs)->Arg(1 << 14)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RadixTreePairs)->Arg(1 << 14)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_KnnGraphPairs)->Arg(1 << 14)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BruteForcePairs)->Arg(1 << 14)->Unit(benchmark::kMillisecond);
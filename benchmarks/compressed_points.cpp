@@ -0,0 +1,117 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/compressed_points.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+// Millimeter grid coordinates within a 100 m cube, or float coordinates
+// within [-100, 100]^3, in z-order.
+template <typename Point>
+std::vector<Point>
+GenerateSortedPoints(std::size_t n, std::true_type /* is_integral */)
+{
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<int32_t> dist(-50000, 50000);
+
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = dist(e2); }
+    }
+
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    return points;
+}
+
+template <typename Point>
+std::vector<Point>
+GenerateSortedPoints(std::size_t n, std::false_type /* is_integral */)
+{
+    auto points = bench::GenerateUniformPoints<Point>(n);
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    return points;
+}
+
+// Decoded bytes per second, the counter ratio is the size of the points
+// over the size of the compressed points.
+template <typename Point>
+void
+BM_DecodeBlocks(benchmark::State& state)
+{
+    using Scalar = typename Point::value_type;
+
+    auto points = GenerateSortedPoints<Point>(std::size_t(1) << 20,
+        std::is_integral<Scalar>());
+    zorder_knn::CompressedPoints<Point, 3> compressed(points.begin(),
+        points.end(), static_cast<std::size_t>(state.range(0)));
+
+    std::vector<Point> block(compressed.BlockSize());
+    for (auto _ : state)
+    {
+        for (std::size_t b{0}; b < compressed.NumBlocks(); ++b)
+        {
+            compressed.DecodeBlock(b, block.data());
+            benchmark::DoNotOptimize(block.data());
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * points.size() * sizeof(Point));
+    state.counters["ratio"] = static_cast<double>(points.size() * sizeof(Point)) /
+        static_cast<double>(compressed.MemoryUsage());
+}
+
+// Copying the uncompressed points for comparison.
+template <typename Point>
+void
+BM_CopyPoints(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(std::size_t(1) << 20);
+    std::vector<Point> copy(points.size());
+
+    for (auto _ : state)
+    {
+        std::memcpy(copy.data(), points.data(), points.size() * sizeof(Point));
+        benchmark::DoNotOptimize(copy.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * points.size() * sizeof(Point));
+}
+
+using Point3f = std::array<float, 3>;
+using Point3i = std::array<int32_t, 3>;
+
+}
+
+BENCHMARK_TEMPLATE(BM_DecodeBlocks, Point3f)->Arg(256)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_DecodeBlocks, Point3i)->Arg(256)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_CopyPoints, Point3f);
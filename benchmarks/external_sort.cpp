@@ -0,0 +1,76 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/external_sort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// Sort a file of range(0) points in runs of range(1) points, range(2)
+// selects reading the input memory-mapped. Time spent in I/O and in
+// sorting and merging is reported separately.
+void
+BM_ExternalSort(benchmark::State& state)
+{
+    std::string input = "zorder_knn_bench_points.bin";
+    std::string output = "zorder_knn_bench_sorted.bin";
+    {
+        auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+        zorder_knn::detail::File file(input, "wb");
+        file.Write(points.data(), sizeof(Point), points.size());
+        file.Close();
+    }
+
+    zorder_knn::ExternalSortOptions options;
+    options.run_size = static_cast<std::size_t>(state.range(1));
+    options.use_mmap = state.range(2) != 0;
+
+    zorder_knn::ExternalSortStats stats;
+    for (auto _ : state)
+    {
+        stats = zorder_knn::ExternalSort<Point, 3>(input, output, options);
+    }
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["io_s"] = stats.io_seconds;
+    state.counters["compute_s"] = stats.compute_seconds;
+    state.counters["runs"] = static_cast<double>(stats.nruns);
+}
+
+}
+
+BENCHMARK(BM_ExternalSort)->ArgNames({ "n", "run", "mmap" })
+    ->Args({ 1 << 24, 1 << 20, 0 })->Args({ 1 << 24, 1 << 20, 1 })
+    ->Args({ 1 << 24, 1 << 22, 0 })
+    ->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,106 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/high_dim_less.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+enum class Comparison { Less, RuntimeLess, HighDimPoints };
+
+inline char const*
+ComparisonName(Comparison c)
+{
+    switch (c)
+    {
+    case Comparison::Less: return "less";
+    case Comparison::RuntimeLess: return "runtime_less";
+    case Comparison::HighDimPoints: return "high_dim_points";
+    }
+
+    return "";
+}
+
+// Sorting the indices of 2^14 points uniform in [0, 1]^d, where no sign
+// mismatch decides a comparison, range(0) selects the comparison.
+// HighDimPoints includes its precomputation.
+template <typename Scalar, std::size_t d>
+void
+BM_HighDimSort(benchmark::State& state)
+{
+    using Point = std::array<Scalar, d>;
+
+    constexpr std::size_t n = 1 << 14;
+    auto points = bench::GeneratePoints<Point>(bench::Distribution::Uniform, n);
+    auto comparison = static_cast<Comparison>(state.range(0));
+
+    std::vector<std::size_t> perm(n);
+    for (auto _ : state)
+    {
+        std::iota(perm.begin(), perm.end(), std::size_t(0));
+
+        switch (comparison)
+        {
+        case Comparison::Less:
+        {
+            zorder_knn::Less<Point, d> less;
+            std::sort(perm.begin(), perm.end(), [&](std::size_t i, std::size_t j) {
+                return less(points[i], points[j]);
+            });
+            break;
+        }
+        case Comparison::RuntimeLess:
+        {
+            zorder_knn::RuntimeLess<Scalar> less{d};
+            std::sort(perm.begin(), perm.end(), [&](std::size_t i, std::size_t j) {
+                return less(points[i].data(), points[j].data());
+            });
+            break;
+        }
+        case Comparison::HighDimPoints:
+        {
+            zorder_knn::HighDimPoints<Scalar> high_dim(points.data()->data(), n, d);
+            perm = high_dim.SortPermutation();
+            break;
+        }
+        }
+
+        benchmark::DoNotOptimize(perm.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetLabel(ComparisonName(comparison));
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_HighDimSort, float, 42)->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(BM_HighDimSort, float, 64)->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(BM_HighDimSort, float, 128)->DenseRange(0, 2);
+BENCHMARK_TEMPLATE(BM_HighDimSort, double, 128)->DenseRange(0, 2);
@@ -0,0 +1,167 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/hilbert.hpp>
+#include <zorder_knn/knn.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point, typename Compare>
+void
+BM_SortOrder(benchmark::State& state)
+{
+    auto dist = static_cast<bench::Distribution>(state.range(0));
+    auto points = bench::GeneratePoints<Point>(dist, std::size_t(1) << 20);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        std::sort(sorted.begin(), sorted.end(), Compare());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t(1) << 20));
+    state.SetLabel(bench::DistributionName(dist));
+}
+
+// Points sorted by Compare and their exact k-nearest neighbor graph in
+// terms of sorted indices.
+template <typename Point, typename Compare>
+struct OrderedKnnGraph
+{
+    static constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    OrderedKnnGraph(bench::Distribution dist, std::size_t n, std::size_t k)
+        : points(bench::GeneratePoints<Point>(dist, n)), graph(n * k)
+    {
+        std::vector<std::size_t> order(n);
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::sort(order.begin(), order.end(), [&](std::size_t i, std::size_t j) {
+            return Compare()(points[i], points[j]);
+        });
+
+        std::vector<std::size_t> rank(n);
+        for (std::size_t i{0}; i < n; ++i) { rank[order[i]] = i; }
+
+        auto knn = zorder_knn::BuildKnnGraph<Point, d>(points, k);
+        for (std::size_t i{0}; i < n; ++i)
+        {
+            for (std::size_t m{0}; m < k; ++m)
+            {
+                graph[rank[i] * k + m] = rank[knn[i * k + m]];
+            }
+        }
+
+        std::vector<Point> sorted(n);
+        for (std::size_t i{0}; i < n; ++i) { sorted[i] = points[order[i]]; }
+        points = std::move(sorted);
+    }
+
+    std::vector<Point> points;
+    std::vector<std::size_t> graph;
+};
+
+// Gather the exact k = 16 nearest neighbors of all points stored in the
+// order of Compare. Reports the fraction of neighbors within the window
+// of the 2k points surrounding each point along the curve, as used by
+// FindKNearest(), and the mean distance of neighbors in memory in units of
+// points, which determines the cache misses of the gather.
+template <typename Point, typename Compare>
+void
+BM_KnnLocality(benchmark::State& state)
+{
+    constexpr std::size_t k = 16;
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    auto dist = static_cast<bench::Distribution>(state.range(0));
+    auto n = std::size_t(1) << 17;
+    OrderedKnnGraph<Point, Compare> knn(dist, n, k);
+
+    for (auto _ : state)
+    {
+        typename Point::value_type sum{0};
+        for (std::size_t i{0}; i < n * k; ++i)
+        {
+            sum += knn.points[knn.graph[i]][d - 1];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    std::size_t nwindow{0};
+    double span{0.0};
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        auto lo = std::min(i > k ? i - k : 0, n - 2 * k - 1);
+        for (std::size_t m{0}; m < k; ++m)
+        {
+            auto j = knn.graph[i * k + m];
+            nwindow += (j >= lo && j <= lo + 2 * k) ? 1 : 0;
+            span += static_cast<double>(j > i ? j - i : i - j);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * k);
+    state.SetLabel(bench::DistributionName(dist));
+    state.counters["recall"] = static_cast<double>(nwindow) / static_cast<double>(n * k);
+    state.counters["span"] = span / static_cast<double>(n * k);
+}
+
+void
+DistributionArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgName("dist")->Arg(static_cast<int64_t>(bench::Distribution::MixedSign))
+        ->Arg(static_cast<int64_t>(bench::Distribution::Clustered));
+}
+
+using Point2 = std::array<float, 2>;
+using Point3 = std::array<float, 3>;
+
+}
+
+BENCHMARK_TEMPLATE(BM_SortOrder, Point2, zorder_knn::Less<Point2, 2>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortOrder, Point2, zorder_knn::HilbertLess<Point2, 2>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortOrder, Point3, zorder_knn::Less<Point3, 3>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SortOrder, Point3, zorder_knn::HilbertLess<Point3, 3>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_KnnLocality, Point2, zorder_knn::Less<Point2, 2>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_KnnLocality, Point2, zorder_knn::HilbertLess<Point2, 2>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_KnnLocality, Point3, zorder_knn::Less<Point3, 3>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_KnnLocality, Point3, zorder_knn::HilbertLess<Point3, 3>)
+    ->Apply(DistributionArgs)->Unit(benchmark::kMillisecond);
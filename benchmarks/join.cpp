@@ -0,0 +1,143 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/join.hpp>
+#include <zorder_knn/range_query.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+constexpr std::size_t num_points = std::size_t(1) << 18;
+
+// Two z-sorted sets of 2^18 points within [-100, 100]^3, a radius of 2
+// yields about one pair per point.
+struct JoinInput
+{
+    JoinInput()
+        : a(bench::GenerateUniformPoints<Point>(num_points)),
+          b(bench::GenerateUniformPoints<Point>(num_points, 7))
+    {
+        std::sort(a.begin(), a.end(), zorder_knn::Less<Point, 3>());
+        std::sort(b.begin(), b.end(), zorder_knn::Less<Point, 3>());
+    }
+
+    std::vector<Point> a, b;
+};
+
+void
+BM_ForEachPairWithin(benchmark::State& state)
+{
+    JoinInput input;
+
+    std::size_t npairs{0};
+    for (auto _ : state)
+    {
+        npairs = 0;
+        zorder_knn::ForEachPairWithin<Point, 3>(input.a, input.b, 2.0f,
+            [&](std::size_t, std::size_t) { ++npairs; });
+        benchmark::DoNotOptimize(npairs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_points);
+    state.counters["pairs"] = static_cast<double>(npairs);
+}
+
+// One box query per point of a, for comparison with the joint traversal.
+void
+BM_PairsWithinByBoxQueries(benchmark::State& state)
+{
+    JoinInput input;
+    constexpr float r = 2.0f;
+
+    std::size_t npairs{0};
+    for (auto _ : state)
+    {
+        npairs = 0;
+        for (auto const& p : input.a)
+        {
+            zorder_knn::Box<Point> box{p, p};
+            for (std::size_t j{0}; j < 3; ++j)
+            {
+                box.lo[j] -= r;
+                box.hi[j] += r;
+            }
+
+            zorder_knn::ForEachInBox<Point, 3>(input.b, box, [&](std::size_t i) {
+                using zorder_knn::detail::SquaredDistance;
+                if (SquaredDistance<Point, 3>(p, input.b[i]) <= r * r) ++npairs;
+            });
+        }
+        benchmark::DoNotOptimize(npairs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_points);
+    state.counters["pairs"] = static_cast<double>(npairs);
+}
+
+void
+BM_NearestJoin(benchmark::State& state)
+{
+    JoinInput input;
+    auto k = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto knn = zorder_knn::NearestJoin<Point, 3>(input.a, input.b, k);
+        benchmark::DoNotOptimize(knn.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+// One FindKNearest() per point of a, for comparison with NearestJoin().
+void
+BM_NearestByQueries(benchmark::State& state)
+{
+    JoinInput input;
+    auto k = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        for (auto const& p : input.a)
+        {
+            auto knn = zorder_knn::FindKNearest<Point, 3>(input.b, p, k);
+            benchmark::DoNotOptimize(knn.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_points);
+}
+
+}
+
+BENCHMARK(BM_ForEachPairWithin)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PairsWithinByBoxQueries)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NearestJoin)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_NearestByQueries)->Arg(1)->Arg(8)->Unit(benchmark::kMillisecond);
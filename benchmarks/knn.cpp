@@ -0,0 +1,104 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/knn.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+void
+BM_BuildKnnGraph(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    auto k = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        auto graph = zorder_knn::BuildKnnGraph<Point, 3>(points, k);
+        benchmark::DoNotOptimize(graph.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Latency of a single query, range(2) selects the exact search. The cost
+// of building the index, i.e. sorting the points, is reported as the
+// sort_ms counter and the fraction of exact neighbors found as recall.
+void
+BM_FindKNearest(benchmark::State& state)
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto k = static_cast<std::size_t>(state.range(1));
+    auto exact = state.range(2) != 0;
+
+    auto points = bench::GenerateUniformPoints<Point>(n);
+    auto queries = bench::GenerateUniformPoints<Point>(1 << 12, 7);
+
+    auto t0 = std::chrono::steady_clock::now();
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::size_t i{0};
+    for (auto _ : state)
+    {
+        auto knn = zorder_knn::FindKNearest<Point, 3>(points,
+            queries[i++ % queries.size()], k, exact);
+        benchmark::DoNotOptimize(knn.data());
+    }
+
+    std::size_t found{0};
+    for (auto const& query : queries)
+    {
+        auto knn = zorder_knn::FindKNearest<Point, 3>(points, query, k, exact);
+        auto exact_knn = zorder_knn::FindKNearest<Point, 3>(points, query, k);
+        std::sort(knn.begin(), knn.end());
+        std::sort(exact_knn.begin(), exact_knn.end());
+
+        std::vector<std::size_t> common;
+        std::set_intersection(knn.begin(), knn.end(), exact_knn.begin(),
+            exact_knn.end(), std::back_inserter(common));
+        found += common.size();
+    }
+
+    state.counters["sort_ms"] = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    state.counters["recall"] = static_cast<double>(found) / static_cast<double>(queries.size() * k);
+}
+
+}
+
+BENCHMARK(BM_FindKNearest)->ArgNames({ "n", "k", "exact" })
+    ->Args({ 1 << 20, 8, 0 })->Args({ 1 << 20, 8, 1 })
+    ->Args({ 1 << 20, 16, 0 })->Args({ 1 << 20, 16, 1 });
+
+BENCHMARK(BM_BuildKnnGraph)
+    ->Args({ 1 << 16, 8 })->Args({ 1 << 20, 8 })->Args({ 1 << 20, 16 })
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,209 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/less.hpp>
+#include <zorder_knn/stats.hpp>
+#include "../tests/sort_zorder.hpp"
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+#ifndef ZORDER_KNN_BENCHMARK_MAX_POINTS
+#define ZORDER_KNN_BENCHMARK_MAX_POINTS 1000000
+#endif
+
+namespace
+{
+
+// Comparisons of consecutive points per second, range(0) selects the
+// distribution.
+template <typename Scalar, std::size_t d>
+void
+BM_LessCompare(benchmark::State& state)
+{
+    using Point = std::array<Scalar, d>;
+
+    constexpr std::size_t n = 1 << 16;
+    auto dist = static_cast<bench::Distribution>(state.range(0));
+    auto points = bench::GeneratePoints<Point>(dist, n);
+
+    zorder_knn::Less<Point, d> less;
+    for (auto _ : state)
+    {
+        std::size_t nless{0};
+        for (std::size_t i{1}; i < n; ++i)
+        {
+            nless += less(points[i - 1], points[i]);
+        }
+        benchmark::DoNotOptimize(nless);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (n - 1));
+    state.SetLabel(bench::DistributionName(dist));
+}
+
+// BM_LessCompare with CountStats, reports the fraction of comparisons
+// decided by a sign mismatch and the fraction of coordinate pairs taking
+// each branch of FloatXorMsb().
+template <typename Scalar, std::size_t d>
+void
+BM_LessCompareStats(benchmark::State& state)
+{
+    using Point = std::array<Scalar, d>;
+
+    constexpr std::size_t n = 1 << 16;
+    auto dist = static_cast<bench::Distribution>(state.range(0));
+    auto points = bench::GeneratePoints<Point>(dist, n);
+
+    auto& counters = zorder_knn::CountStats::Counters();
+    counters.Reset();
+
+    zorder_knn::Less<Point, d, zorder_knn::XorMsbTable, zorder_knn::CountStats> less;
+    for (auto _ : state)
+    {
+        std::size_t nless{0};
+        for (std::size_t i{1}; i < n; ++i)
+        {
+            nless += less(points[i - 1], points[i]);
+        }
+        benchmark::DoNotOptimize(nless);
+    }
+
+    auto ncompare = static_cast<double>(counters.ncompare);
+    auto ncoord = static_cast<double>(counters.ncoord_equal +
+        counters.ncoord_equal_exp + counters.ncoord_diff_exp);
+
+    state.SetItemsProcessed(state.iterations() * (n - 1));
+    state.SetLabel(bench::DistributionName(dist));
+    state.counters["sign"] = counters.nsign_mismatch / ncompare;
+    state.counters["equal"] = counters.ncoord_equal / ncoord;
+    state.counters["equal_exp"] = counters.ncoord_equal_exp / ncoord;
+    state.counters["diff_exp"] = counters.ncoord_diff_exp / ncoord;
+}
+
+// Points sorted per second, range(0) is the number of points and
+// range(1) selects the distribution.
+template <typename Scalar, std::size_t d>
+void
+BM_LessSort(benchmark::State& state)
+{
+    using Point = std::array<Scalar, d>;
+
+    auto dist = static_cast<bench::Distribution>(state.range(1));
+    auto points = bench::GeneratePoints<Point>(dist, state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        std::sort(sorted.begin(), sorted.end(), zorder_knn::Less<Point, d>());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(bench::DistributionName(dist));
+}
+
+// The recursive reference implementation of the tests.
+template <typename Scalar, std::size_t d>
+void
+BM_SortZOrder(benchmark::State& state)
+{
+    using Point = std::array<Scalar, d>;
+
+    auto dist = static_cast<bench::Distribution>(state.range(1));
+    auto points = bench::GeneratePoints<Point>(dist, state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        test::SortZOrder(sorted);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(bench::DistributionName(dist));
+}
+
+void
+CompareArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgName("dist");
+    for (auto dist : bench::Distributions) { b->Arg(static_cast<int64_t>(dist)); }
+}
+
+void
+SortArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "n", "dist" })->Unit(benchmark::kMillisecond);
+    for (int64_t n{1000}; n <= ZORDER_KNN_BENCHMARK_MAX_POINTS; n *= 10)
+    {
+        for (auto dist : bench::Distributions)
+        {
+            b->Args({ n, static_cast<int64_t>(dist) });
+        }
+    }
+}
+
+// The reference implementation recurses without end on duplicate points,
+// which the grid distribution contains.
+void
+SortZOrderArgs(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({ "n", "dist" })->Unit(benchmark::kMillisecond);
+    for (int64_t n{1000}; n <= ZORDER_KNN_BENCHMARK_MAX_POINTS; n *= 10)
+    {
+        for (auto dist : bench::Distributions)
+        {
+            if (dist == bench::Distribution::Grid) continue;
+            b->Args({ n, static_cast<int64_t>(dist) });
+        }
+    }
+}
+
+}
+
+#define ZORDER_KNN_BENCHMARK_LESS(Scalar, d) \
+    BENCHMARK_TEMPLATE(BM_LessCompare, Scalar, d)->Apply(CompareArgs); \
+    BENCHMARK_TEMPLATE(BM_LessSort, Scalar, d)->Apply(SortArgs); \
+    BENCHMARK_TEMPLATE(BM_SortZOrder, Scalar, d)->Apply(SortZOrderArgs)
+
+ZORDER_KNN_BENCHMARK_LESS(float, 2);
+ZORDER_KNN_BENCHMARK_LESS(float, 3);
+ZORDER_KNN_BENCHMARK_LESS(float, 4);
+ZORDER_KNN_BENCHMARK_LESS(float, 6);
+ZORDER_KNN_BENCHMARK_LESS(float, 42);
+ZORDER_KNN_BENCHMARK_LESS(double, 2);
+ZORDER_KNN_BENCHMARK_LESS(double, 3);
+ZORDER_KNN_BENCHMARK_LESS(double, 4);
+ZORDER_KNN_BENCHMARK_LESS(double, 6);
+ZORDER_KNN_BENCHMARK_LESS(double, 42);
+
+BENCHMARK_TEMPLATE(BM_LessCompareStats, float, 3)->Apply(CompareArgs);
@@ -0,0 +1,130 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/merge.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <queue>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// range(1) z-sorted tiles of range(0) points in total.
+std::vector<std::vector<Point>>
+GenerateTiles(std::size_t n, std::size_t k)
+{
+    auto points = bench::GenerateUniformPoints<Point>(n);
+
+    std::vector<std::vector<Point>> tiles(k);
+    for (std::size_t i{0}; i < k; ++i)
+    {
+        tiles[i].assign(points.begin() + n * i / k, points.begin() + n * (i + 1) / k);
+        std::sort(tiles[i].begin(), tiles[i].end(), zorder_knn::Less<Point, 3>());
+    }
+
+    return tiles;
+}
+
+void
+BM_MergeSorted(benchmark::State& state)
+{
+    auto tiles = GenerateTiles(state.range(0), state.range(1));
+
+    for (auto _ : state)
+    {
+        auto merged = zorder_knn::MergeSorted<Point, 3>(tiles);
+        benchmark::DoNotOptimize(merged.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Merge by a binary heap, for comparison with the loser tree.
+void
+BM_MergeSortedHeap(benchmark::State& state)
+{
+    auto tiles = GenerateTiles(state.range(0), state.range(1));
+    zorder_knn::Less<Point, 3> less;
+
+    for (auto _ : state)
+    {
+        std::vector<std::size_t> heads(tiles.size(), 0);
+        auto after = [&](std::size_t a, std::size_t b) {
+            return less(tiles[b][heads[b]], tiles[a][heads[a]]);
+        };
+        std::priority_queue<std::size_t, std::vector<std::size_t>,
+            decltype(after)> heap(after);
+        for (std::size_t i{0}; i < tiles.size(); ++i)
+        {
+            if (!tiles[i].empty()) heap.push(i);
+        }
+
+        std::vector<Point> merged;
+        merged.reserve(state.range(0));
+        while (!heap.empty())
+        {
+            auto i = heap.top();
+            heap.pop();
+            merged.push_back(tiles[i][heads[i]]);
+            if (++heads[i] < tiles[i].size()) heap.push(i);
+        }
+        benchmark::DoNotOptimize(merged.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Sorting the concatenated tiles ignores their order.
+void
+BM_SortConcatenation(benchmark::State& state)
+{
+    auto tiles = GenerateTiles(state.range(0), state.range(1));
+
+    for (auto _ : state)
+    {
+        std::vector<Point> merged;
+        merged.reserve(state.range(0));
+        for (auto const& tile : tiles) { merged.insert(merged.end(), tile.begin(), tile.end()); }
+        std::sort(merged.begin(), merged.end(), zorder_knn::Less<Point, 3>());
+        benchmark::DoNotOptimize(merged.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+TileCounts(benchmark::internal::Benchmark* b)
+{
+    for (int64_t k : { 4, 16, 64, 256 }) { b->Args({ 1 << 20, k }); }
+}
+
+}
+
+BENCHMARK(BM_MergeSorted)->Apply(TileCounts)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MergeSortedHeap)->Apply(TileCounts)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortConcatenation)->Apply(TileCounts)->Unit(benchmark::kMillisecond);
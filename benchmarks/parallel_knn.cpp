@@ -0,0 +1,69 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/parallel_knn.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// Strong scaling of the graph build over the number of threads, range(2),
+// which runs from one thread up to all available cores.
+void
+BM_ParallelBuildKnnGraph(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    auto k = static_cast<std::size_t>(state.range(1));
+    zorder_knn::ThreadPool pool(static_cast<std::size_t>(state.range(2)));
+
+    for (auto _ : state)
+    {
+        auto graph = zorder_knn::ParallelBuildKnnGraph<Point, 3>(pool, points, k);
+        benchmark::DoNotOptimize(graph.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["threads"] = static_cast<double>(pool.NumThreads());
+}
+
+void
+ThreadCounts(benchmark::internal::Benchmark* b)
+{
+    auto max_threads = static_cast<int64_t>(zorder_knn::DefaultNumThreads());
+
+    for (int64_t k : { 8, 16 })
+    {
+        for (int64_t t{1}; t < max_threads; t *= 2) { b->Args({ 1 << 20, k, t }); }
+        b->Args({ 1 << 20, k, max_threads });
+    }
+}
+
+}
+
+BENCHMARK(BM_ParallelBuildKnnGraph)->Apply(ThreadCounts)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,111 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/parallel_sort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+void
+BM_StdSortLess(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        std::sort(sorted.begin(), sorted.end(), zorder_knn::Less<Point, 3>());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+BM_Sort(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        zorder_knn::Sort<Point, 3>(sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Speedup over the number of threads, range(1), which runs from one
+// thread up to all available cores.
+void
+BM_ParallelSort(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    zorder_knn::ThreadPool pool(static_cast<std::size_t>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        zorder_knn::ParallelSort<Point, 3>(pool, sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["threads"] = static_cast<double>(pool.NumThreads());
+}
+
+void
+ThreadCounts(benchmark::internal::Benchmark* b)
+{
+    auto max_threads = static_cast<int64_t>(zorder_knn::DefaultNumThreads());
+
+    for (int64_t n : { int64_t(1) << 20, int64_t(1) << 24 })
+    {
+        for (int64_t t{1}; t < max_threads; t *= 2) { b->Args({ n, t }); }
+        b->Args({ n, max_threads });
+    }
+}
+
+}
+
+BENCHMARK(BM_StdSortLess)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Sort)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelSort)->Apply(ThreadCounts)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,136 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/sort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// LiDAR like record of 96 bytes.
+struct Record
+{
+    Point position;
+    float intensity;
+    uint64_t timestamp;
+    char attributes[72];
+};
+
+std::vector<Record>
+GenerateRecords(std::size_t n)
+{
+    auto points = bench::GenerateUniformPoints<Point>(n);
+
+    std::vector<Record> records(n);
+    for (std::size_t i{0}; i < n; ++i) { records[i].position = points[i]; }
+
+    return records;
+}
+
+void
+BM_StdSortRecords(benchmark::State& state)
+{
+    auto records = GenerateRecords(state.range(0));
+    zorder_knn::Less<Point, 3> less;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = records;
+        state.ResumeTiming();
+
+        std::sort(sorted.begin(), sorted.end(), [&](Record const& r0, Record const& r1) {
+            return less(r0.position, r1.position);
+        });
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+BM_SortRecords(benchmark::State& state)
+{
+    auto records = GenerateRecords(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = records;
+        state.ResumeTiming();
+
+        zorder_knn::Sort<Point, 3>(sorted.begin(), sorted.end(), &Record::position);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void
+BM_SortPermutationRecords(benchmark::State& state)
+{
+    auto records = GenerateRecords(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto perm = zorder_knn::SortPermutation<Point, 3, uint32_t>(
+            records.begin(), records.end(), &Record::position);
+        benchmark::DoNotOptimize(perm.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Reorder three attribute arrays.
+void
+BM_ApplyPermutation(benchmark::State& state)
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto points = bench::GenerateUniformPoints<Point>(n);
+    auto perm = zorder_knn::SortPermutation<Point, 3, uint32_t>(points.begin(),
+        points.end());
+
+    std::vector<float> intensity(n);
+    std::vector<uint64_t> timestamp(n);
+
+    for (auto _ : state)
+    {
+        zorder_knn::ApplyPermutation(perm, points, intensity, timestamp);
+        benchmark::DoNotOptimize(points.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(BM_StdSortRecords)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortRecords)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortPermutationRecords)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ApplyPermutation)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
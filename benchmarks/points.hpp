@@ -0,0 +1,174 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_BENCHMARKS_POINTS_HPP
+#define ZORDER_KNN_BENCHMARKS_POINTS_HPP
+
+#include <zorder_knn/less.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+#include <array>
+#include <algorithm>
+
+namespace bench
+{
+
+template <typename Point>
+std::vector<Point>
+GenerateUniformPoints(std::size_t n, unsigned seed = 42)
+{
+    using Scalar = typename Point::value_type;
+
+    std::mt19937 e2(seed);
+    std::uniform_real_distribution<Scalar> dist(Scalar(-100), Scalar(100));
+
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        std::generate(p.begin(), p.end(), [&] { return dist(e2); });
+    }
+
+    return points;
+}
+
+// Points normally distributed around uniformly distributed cluster
+// centers, nearby coordinates mostly share their exponents.
+template <typename Point>
+std::vector<Point>
+GenerateClusteredPoints(std::size_t n, std::size_t nclusters = 64,
+    unsigned seed = 42)
+{
+    using Scalar = typename Point::value_type;
+
+    auto centers = GenerateUniformPoints<Point>(nclusters, seed);
+
+    std::mt19937 e2(seed + 1);
+    std::uniform_int_distribution<std::size_t> cluster(0, nclusters - 1);
+    std::normal_distribution<Scalar> dist(Scalar(0), Scalar(0.5));
+
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        auto const& c = centers[cluster(e2)];
+        for (std::size_t j{0}; j < p.size(); ++j) { p[j] = c[j] + dist(e2); }
+    }
+
+    return points;
+}
+
+// Integer coordinates on a grid of about n cells, many points share
+// coordinates and all coordinates share few exponents.
+template <typename Point>
+std::vector<Point>
+GenerateGridPoints(std::size_t n, unsigned seed = 42)
+{
+    using Scalar = typename Point::value_type;
+    auto d = std::tuple_size<Point>::value;
+
+    auto side = std::max(2, static_cast<int>(std::round(
+        std::pow(static_cast<double>(n), 1.0 / static_cast<double>(d)))));
+
+    std::mt19937 e2(seed);
+    std::uniform_int_distribution<int> dist(0, side - 1);
+
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        std::generate(p.begin(), p.end(),
+            [&] { return static_cast<Scalar>(dist(e2)); });
+    }
+
+    return points;
+}
+
+enum class Distribution
+{
+    // uniform in [0, 1]^d
+    Uniform,
+    Clustered,
+    Grid,
+    // uniform in [-100, 100]^d, already in z-order
+    Sorted,
+    // uniform in [-100, 100]^d
+    MixedSign
+};
+
+constexpr Distribution Distributions[] = { Distribution::Uniform,
+    Distribution::Clustered, Distribution::Grid, Distribution::Sorted,
+    Distribution::MixedSign };
+
+inline char const*
+DistributionName(Distribution dist)
+{
+    switch (dist)
+    {
+    case Distribution::Uniform: return "uniform";
+    case Distribution::Clustered: return "clustered";
+    case Distribution::Grid: return "grid";
+    case Distribution::Sorted: return "sorted";
+    case Distribution::MixedSign: return "mixed_sign";
+    }
+
+    return "";
+}
+
+template <typename Point>
+std::vector<Point>
+GeneratePoints(Distribution dist, std::size_t n, unsigned seed = 42)
+{
+    using Scalar = typename Point::value_type;
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    std::vector<Point> points;
+    switch (dist)
+    {
+    case Distribution::Uniform:
+        points = GenerateUniformPoints<Point>(n, seed);
+        for (auto& p : points)
+        {
+            for (auto& x : p) { x = (x + Scalar(100)) / Scalar(200); }
+        }
+        break;
+    case Distribution::Clustered:
+        points = GenerateClusteredPoints<Point>(n, 64, seed);
+        break;
+    case Distribution::Grid:
+        points = GenerateGridPoints<Point>(n, seed);
+        break;
+    case Distribution::Sorted:
+        points = GenerateUniformPoints<Point>(n, seed);
+        std::sort(points.begin(), points.end(), zorder_knn::Less<Point, d>());
+        break;
+    case Distribution::MixedSign:
+        points = GenerateUniformPoints<Point>(n, seed);
+        break;
+    }
+
+    return points;
+}
+
+} // namespace bench
+
+#endif // ZORDER_KNN_BENCHMARKS_POINTS_HPP
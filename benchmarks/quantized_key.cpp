@@ -0,0 +1,85 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/quantized_key.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+// Keys encoded per second for 2^20 points within [-100, 100]^d.
+template <typename Point, typename Key>
+void
+BM_QuantizedKeys(benchmark::State& state)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+
+    auto points = bench::GenerateUniformPoints<Point>(std::size_t(1) << 20);
+
+    zorder_knn::Box<Point> box;
+    box.lo.fill(Scalar(-100));
+    box.hi.fill(Scalar(100));
+    zorder_knn::QuantizedKeyCoder<Point, d, Key> coder(box);
+
+    std::vector<Key> keys(points.size());
+    for (auto _ : state)
+    {
+        coder.Encode(points.begin(), points.end(), keys.begin());
+        benchmark::DoNotOptimize(keys.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+// Exact morton keys of the float z-order for comparison.
+template <typename Point>
+void
+BM_ExactKeys(benchmark::State& state)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    auto points = bench::GenerateUniformPoints<Point>(std::size_t(1) << 20);
+    auto layout = zorder_knn::MakeKeyLayout<Point, d>(points.begin(), points.end());
+
+    for (auto _ : state)
+    {
+        auto keys = zorder_knn::MakeKeys<Point, d>(layout, points.begin(), points.end());
+        benchmark::DoNotOptimize(keys.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+using Point2 = std::array<float, 2>;
+using Point3 = std::array<float, 3>;
+
+}
+
+BENCHMARK_TEMPLATE(BM_QuantizedKeys, Point2, uint64_t);
+BENCHMARK_TEMPLATE(BM_QuantizedKeys, Point3, uint64_t);
+BENCHMARK_TEMPLATE(BM_QuantizedKeys, Point3, zorder_knn::QuantizedKey128);
+BENCHMARK_TEMPLATE(BM_ExactKeys, Point3);
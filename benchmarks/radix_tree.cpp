@@ -0,0 +1,104 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/radix_tree.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+void
+BM_RadixTreeBuild(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    zorder_knn::ThreadPool pool(static_cast<std::size_t>(state.range(1)));
+
+    for (auto _ : state)
+    {
+        zorder_knn::RadixTree<Point, 3> tree(pool, points);
+        benchmark::DoNotOptimize(tree.NodeBox(0));
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Queries of range(1) nearest neighbors against 2^20 points, by the tree
+// if range(2) is set and otherwise by FindKNearest() on the sorted array.
+void
+BM_RadixTreeKNearest(benchmark::State& state)
+{
+    auto k = static_cast<std::size_t>(state.range(0));
+    auto use_tree = state.range(1) != 0;
+
+    auto points = bench::GenerateUniformPoints<Point>(1 << 20);
+    auto queries = bench::GenerateUniformPoints<Point>(1 << 12, 7);
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    zorder_knn::RadixTree<Point, 3> tree(points);
+
+    std::size_t i{0};
+    for (auto _ : state)
+    {
+        auto const& query = queries[i++ % queries.size()];
+        auto knn = use_tree ? tree.FindKNearest(query, k)
+                            : zorder_knn::FindKNearest<Point, 3>(points, query, k);
+        benchmark::DoNotOptimize(knn.data());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Radius queries against 2^20 points, a radius of 2 yields about 4
+// points.
+void
+BM_RadixTreeWithin(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(1 << 20);
+    auto queries = bench::GenerateUniformPoints<Point>(1 << 12, 7);
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    zorder_knn::RadixTree<Point, 3> tree(points);
+
+    std::size_t i{0}, found{0};
+    for (auto _ : state)
+    {
+        tree.ForEachWithin(queries[i++ % queries.size()], 2.0f,
+            [&found](std::size_t) { ++found; });
+    }
+    benchmark::DoNotOptimize(found);
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_RadixTreeBuild)->Args({ 1 << 20, 1 })->Args({ 1 << 20, 4 })
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RadixTreeKNearest)->ArgNames({ "k", "tree" })
+    ->Args({ 8, 0 })->Args({ 8, 1 })->Args({ 16, 0 })->Args({ 16, 1 });
+BENCHMARK(BM_RadixTreeWithin);
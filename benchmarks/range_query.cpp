@@ -0,0 +1,94 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/range_query.hpp>
+#include <zorder_knn/sort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// Cubes of edge length range(1) out of 200 centered at random points.
+std::vector<zorder_knn::Box<Point>>
+GenerateBoxes(float edge)
+{
+    auto centers = bench::GenerateUniformPoints<Point>(1 << 10, 7);
+
+    std::vector<zorder_knn::Box<Point>> boxes;
+    for (auto const& c : centers)
+    {
+        auto r = 0.5f * edge;
+        boxes.push_back({ { { c[0] - r, c[1] - r, c[2] - r } },
+            { { c[0] + r, c[1] + r, c[2] + r } } });
+    }
+
+    return boxes;
+}
+
+// Box query among range(0) z-sorted points, range(2) selects the
+// BIGMIN/LITMAX search over a scan of the z-range of the box.
+void
+BM_FindInBox(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+    auto boxes = GenerateBoxes(static_cast<float>(state.range(1)));
+    auto bigmin = state.range(2) != 0;
+
+    zorder_knn::Less<Point, 3> less;
+    std::size_t i{0}, nfound{0};
+    for (auto _ : state)
+    {
+        auto const& box = boxes[i++ % boxes.size()];
+        auto count = [&](std::size_t) { ++nfound; };
+
+        if (bigmin)
+        {
+            zorder_knn::ForEachInBox<Point, 3>(points, box, count);
+        }
+        else
+        {
+            auto first = std::lower_bound(points.begin(), points.end(), box.lo, less);
+            auto last = std::upper_bound(first, points.end(), box.hi, less);
+            for (auto it = first; it != last; ++it)
+            {
+                if (zorder_knn::detail::Contains<Point, 3>(box, *it)) count(0);
+            }
+        }
+    }
+
+    state.counters["found"] = benchmark::Counter(static_cast<double>(nfound),
+        benchmark::Counter::kAvgIterations);
+}
+
+}
+
+BENCHMARK(BM_FindInBox)->ArgNames({ "n", "edge", "bigmin" })
+    ->ArgsProduct({ { 1 << 20, 1 << 23 }, { 2, 10, 40 }, { 0, 1 } })
+    ->Unit(benchmark::kMicrosecond);
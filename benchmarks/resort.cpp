@@ -0,0 +1,97 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/resort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// Points in [-100, 100]^3 sorted in z-order and then moved by up to
+// 10^-range(1) per coordinate, so that about 2^range(0) points lie in a
+// cube of edge length 200.
+std::vector<Point>
+GenerateMovedPoints(std::size_t n, int64_t delta_exp)
+{
+    auto points = bench::GenerateUniformPoints<Point>(n);
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+    std::mt19937 e2(3);
+    auto delta = static_cast<float>(std::pow(10.0, -static_cast<double>(delta_exp)));
+    std::uniform_real_distribution<float> dist(-delta, delta);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x += dist(e2); }
+    }
+
+    return points;
+}
+
+// Restore the z-order after a displacement of 10^-range(1), range(2)
+// selects Resort(), Sort() or std::sort() with Less.
+void
+BM_Resort(benchmark::State& state)
+{
+    auto points = GenerateMovedPoints(state.range(0), state.range(1));
+
+    auto method = zorder_knn::ResortMethod::None;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        switch (state.range(2))
+        {
+        case 0:
+            method = zorder_knn::Resort<Point, 3>(sorted.begin(), sorted.end());
+            break;
+        case 1:
+            zorder_knn::Sort<Point, 3>(sorted.begin(), sorted.end());
+            break;
+        default:
+            std::sort(sorted.begin(), sorted.end(), zorder_knn::Less<Point, 3>());
+            break;
+        }
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    if (state.range(2) == 0)
+    {
+        state.counters["method"] = static_cast<double>(method);
+    }
+}
+
+}
+
+BENCHMARK(BM_Resort)->ArgNames({ "n", "delta_exp", "method" })
+    ->ArgsProduct({ { 1 << 20 }, { 4, 3, 2, 1, 0 }, { 0, 1, 2 } })
+    ->Unit(benchmark::kMillisecond);
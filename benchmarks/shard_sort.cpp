@@ -0,0 +1,92 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/shard_sort.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <thread>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+// Sample sort of range(0) points spread evenly over range(1) shards, each
+// one a thread connected by the loopback transport. The imbalance of the
+// resulting shards is reported as a counter.
+void
+BM_ShardSort(benchmark::State& state)
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto nshards = static_cast<std::size_t>(state.range(1));
+    auto dist = static_cast<bench::Distribution>(state.range(2));
+    auto points = bench::GeneratePoints<Point>(dist, n);
+
+    double imbalance{1.0};
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::vector<std::vector<Point>> shards(nshards);
+        for (std::size_t r{0}; r < nshards; ++r)
+        {
+            shards[r].assign(points.begin() + n * r / nshards,
+                points.begin() + n * (r + 1) / nshards);
+        }
+        state.ResumeTiming();
+
+        zorder_knn::LoopbackHub hub(nshards);
+        std::vector<std::thread> threads;
+        for (std::size_t r{0}; r < nshards; ++r)
+        {
+            threads.emplace_back([&, r] {
+                zorder_knn::LoopbackTransport transport(hub, r);
+                auto stats = zorder_knn::ShardSort<Point, 3>(transport, shards[r]);
+                if (r == 0) imbalance = stats.imbalance;
+            });
+        }
+        for (auto& t : threads) { t.join(); }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["imbalance"] = imbalance;
+    state.SetLabel(bench::DistributionName(dist));
+}
+
+void
+ShardCounts(benchmark::internal::Benchmark* b)
+{
+    for (auto dist : bench::Distributions)
+    {
+        for (int64_t p : { 1, 4, 16 })
+        {
+            b->Args({ 1 << 20, p, static_cast<int64_t>(dist) });
+        }
+    }
+}
+
+}
+
+BENCHMARK(BM_ShardSort)->Apply(ShardCounts)->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,109 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/simd_less.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Less, typename Point>
+void
+BM_StdSort(benchmark::State& state)
+{
+    auto points = bench::GenerateUniformPoints<Point>(state.range(0));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        std::sort(sorted.begin(), sorted.end(), Less());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Compare all points against a pivot, one at a time or lane-parallel.
+template <typename Point, bool batch>
+void
+BM_ComparePivot(benchmark::State& state)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto points = bench::GenerateUniformPoints<Point>(n);
+    std::unique_ptr<bool[]> out(new bool[n]);
+
+    zorder_knn::Less<Point, d> less;
+    std::size_t i{0};
+
+    for (auto _ : state)
+    {
+        auto const& pivot = points[i++ % n];
+        if (batch)
+        {
+            zorder_knn::LessBatch<Point, d>(points.data(), n, pivot, out.get());
+        }
+        else
+        {
+            for (std::size_t j{0}; j < n; ++j) { out[j] = less(points[j], pivot); }
+        }
+        benchmark::DoNotOptimize(out.get());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Point>
+using Less = zorder_knn::Less<Point, std::tuple_size<Point>::value>;
+
+template <typename Point>
+using SimdLess = zorder_knn::SimdLess<Point, std::tuple_size<Point>::value>;
+
+using Float2 = std::array<float, 2>;
+using Float3 = std::array<float, 3>;
+using Float4 = std::array<float, 4>;
+using Double3 = std::array<double, 3>;
+
+}
+
+BENCHMARK_TEMPLATE(BM_StdSort, Less<Float2>, Float2)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, SimdLess<Float2>, Float2)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, Less<Float3>, Float3)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, SimdLess<Float3>, Float3)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, Less<Float4>, Float4)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, SimdLess<Float4>, Float4)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, Less<Double3>, Double3)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSort, SimdLess<Double3>, Double3)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_ComparePivot, Float3, false)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_ComparePivot, Float3, true)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_ComparePivot, Double3, false)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_ComparePivot, Double3, true)->Arg(1 << 12);
@@ -0,0 +1,105 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/soa.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+std::array<std::vector<float>, 3>
+GenerateColumns(std::size_t n)
+{
+    auto points = bench::GenerateUniformPoints<Point>(n);
+
+    std::array<std::vector<float>, 3> columns;
+    for (std::size_t j{0}; j < 3; ++j)
+    {
+        for (auto const& p : points) { columns[j].push_back(p[j]); }
+    }
+
+    return columns;
+}
+
+// Sort the columns directly.
+void
+BM_SortSoa(benchmark::State& state)
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto columns = GenerateColumns(n);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = columns;
+        state.ResumeTiming();
+
+        zorder_knn::SoaPoints<float, 3> points{
+            {{ sorted[0].data(), sorted[1].data(), sorted[2].data() }}, n };
+        zorder_knn::Sort(points);
+        benchmark::DoNotOptimize(sorted[0].data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Transpose the columns to points, sort and transpose back.
+void
+BM_SortTransposed(benchmark::State& state)
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto columns = GenerateColumns(n);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = columns;
+        state.ResumeTiming();
+
+        std::vector<Point> points(n);
+        for (std::size_t i{0}; i < n; ++i)
+        {
+            points[i] = {{ sorted[0][i], sorted[1][i], sorted[2][i] }};
+        }
+
+        zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+        for (std::size_t i{0}; i < n; ++i)
+        {
+            for (std::size_t j{0}; j < 3; ++j) { sorted[j][i] = points[i][j]; }
+        }
+        benchmark::DoNotOptimize(sorted[0].data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(BM_SortSoa)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SortTransposed)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
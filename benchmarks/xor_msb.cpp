@@ -0,0 +1,95 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/less.hpp>
+#include "points.hpp"
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+
+std::vector<Point>
+GeneratePoints(int64_t clustered, std::size_t n)
+{
+    return clustered ? bench::GenerateClusteredPoints<Point>(n)
+                     : bench::GenerateUniformPoints<Point>(n);
+}
+
+// XorMsb of consecutive coordinates, range(0) selects clustered points.
+template <typename XorMsb>
+void
+BM_XorMsb(benchmark::State& state)
+{
+    constexpr std::size_t n = 1 << 16;
+    auto points = GeneratePoints(state.range(0), n);
+
+    XorMsb xor_msb;
+    for (auto _ : state)
+    {
+        int sum{0};
+        for (std::size_t i{1}; i < n; ++i)
+        {
+            for (std::size_t j{0}; j < 3; ++j)
+            {
+                sum += xor_msb(points[i - 1][j], points[i][j]);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * (n - 1) * 3);
+}
+
+template <typename XorMsb>
+void
+BM_StdSortLess(benchmark::State& state)
+{
+    auto points = GeneratePoints(state.range(0), std::size_t(1) << 20);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto sorted = points;
+        state.ResumeTiming();
+
+        std::sort(sorted.begin(), sorted.end(),
+            zorder_knn::Less<Point, 3, XorMsb>());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * (int64_t(1) << 20));
+}
+
+}
+
+BENCHMARK_TEMPLATE(BM_XorMsb, zorder_knn::XorMsbTable)->ArgName("clustered")->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_XorMsb, zorder_knn::XorMsbClz)->ArgName("clustered")->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_StdSortLess, zorder_knn::XorMsbTable)->ArgName("clustered")->Arg(0)->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_StdSortLess, zorder_knn::XorMsbClz)->ArgName("clustered")->Arg(0)->Arg(1)
+    ->Unit(benchmark::kMillisecond);
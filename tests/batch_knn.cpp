@@ -0,0 +1,99 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/batch_knn.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestFindKNearestBatch(std::vector<Point> points,
+    std::vector<Point> const& queries, std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, d>());
+
+    for (auto exact : { true, false })
+    {
+        for (std::size_t nthreads : { 1, 4 })
+        {
+            auto knn = zorder_knn::FindKNearestBatch<Point, d>(points, queries,
+                k, exact, nthreads);
+            auto kk = std::min(k, points.size());
+            ASSERT_EQ(knn.size(), queries.size() * kk);
+
+            for (std::size_t i{0}; i < queries.size(); ++i)
+            {
+                auto expected = zorder_knn::FindKNearest<Point, d>(points,
+                    queries[i], k, exact);
+                std::vector<std::size_t> row(knn.begin() + i * kk,
+                    knn.begin() + (i + 1) * kk);
+                EXPECT_EQ(row, expected);
+            }
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestFindKNearestBatchRandom(std::size_t k)
+{
+    std::vector<std::array<double, d>> points(n), queries(1000);
+    test::GenerateRandomPoints(points);
+    test::GenerateRandomPoints(queries);
+
+    // queries beyond the points, on top of them and duplicated
+    for (std::size_t i{0}; i < 100; ++i)
+    {
+        for (auto& x : queries[i]) { x *= 4.0; }
+        queries[100 + i] = points[i];
+        queries[200 + i] = queries[300 + i];
+    }
+
+    TestFindKNearestBatch(points, queries, k);
+    TestFindKNearestBatch(test::CastDoubleToFloat(points),
+        test::CastDoubleToFloat(queries), k);
+}
+
+}
+
+TEST(FindKNearestBatch, Random2D_2k) { TestFindKNearestBatchRandom<2000, 2>(1); TestFindKNearestBatchRandom<2000, 2>(8); }
+TEST(FindKNearestBatch, Random3D_2k) { TestFindKNearestBatchRandom<2000, 3>(10); }
+TEST(FindKNearestBatch, Random6D_1k) { TestFindKNearestBatchRandom<1000, 6>(16); }
+
+TEST(FindKNearestBatch, Small)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> points = {{ {{ 1.0f, 2.0f }}, {{ -1.0f, 0.5f }}, {{ 3.0f, -2.0f }} }};
+    std::vector<Point> queries = {{ {{ 0.0f, 0.0f }}, {{ 10.0f, 10.0f }} }};
+
+    TestFindKNearestBatch(points, queries, 5);
+    EXPECT_TRUE((zorder_knn::FindKNearestBatch<Point, 2>(points, {}, 2).empty()));
+    EXPECT_TRUE((zorder_knn::FindKNearestBatch<Point, 2>({}, queries, 2).empty()));
+}
@@ -0,0 +1,199 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/block_file.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <array>
+
+#if defined(ZORDER_KNN_HAS_MMAP)
+
+namespace
+{
+
+template <typename Point>
+void
+TestBlockFile(std::vector<Point> points, std::size_t block_size)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, d>());
+
+    auto path = testing::TempDir() + "zorder_knn_blocks.bin";
+    zorder_knn::WriteBlockFile<Point, d>(path, points.begin(), points.end(),
+        block_size);
+
+    {
+        zorder_knn::BlockFileReader<Point, d> reader(path);
+        ASSERT_EQ(reader.Size(), points.size());
+        EXPECT_EQ(reader.BlockSize(), block_size);
+        EXPECT_EQ(reader.NumBlocks(),
+            (points.size() + block_size - 1) / block_size);
+        EXPECT_TRUE(std::equal(points.begin(), points.end(), reader.Data()));
+
+        zorder_knn::Less<Point, d> less;
+        for (std::size_t b{0}; b < reader.NumBlocks(); ++b)
+        {
+            auto const& info = reader.Block(b);
+            EXPECT_EQ(info.first, *reader.BlockBegin(b));
+            EXPECT_EQ(info.last, *(reader.BlockEnd(b) - 1));
+
+            for (auto* p = reader.BlockBegin(b); p != reader.BlockEnd(b); ++p)
+            {
+                EXPECT_TRUE((zorder_knn::detail::Contains<Point, d>(info.box, *p)));
+                EXPECT_FALSE(less(*p, info.first));
+                EXPECT_FALSE(less(info.last, *p));
+            }
+        }
+
+        std::mt19937 e2(7);
+        std::uniform_real_distribution<Scalar> dist(-10, 10);
+        for (int i{0}; i < 50; ++i)
+        {
+            zorder_knn::Box<Point> box;
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                auto x0 = dist(e2), x1 = dist(e2);
+                box.lo[j] = std::min(x0, x1);
+                box.hi[j] = std::max(x0, x1);
+            }
+
+            std::vector<std::size_t> expected;
+            for (std::size_t k{0}; k < points.size(); ++k)
+            {
+                if (zorder_knn::detail::Contains<Point, d>(box, points[k]))
+                    expected.push_back(k);
+            }
+
+            std::vector<std::size_t> found;
+            reader.ForEachInBox(box, [&](std::size_t k, Point const& p) {
+                EXPECT_EQ(p, points[k]);
+                found.push_back(k);
+            });
+
+            EXPECT_EQ(found, expected);
+        }
+    }
+
+    std::remove(path.c_str());
+}
+
+}
+
+TEST(BlockFile, Random)
+{
+    std::vector<std::array<double, 3>> points(10000);
+    test::GenerateRandomPoints(points);
+
+    TestBlockFile(points, 64);
+    TestBlockFile(points, 1000);
+    TestBlockFile(test::CastDoubleToFloat(points), 300);
+}
+
+TEST(BlockFile, Grid)
+{
+    // many points on the boundaries of the query boxes
+    using Point = std::array<float, 2>;
+    std::vector<Point> points;
+    for (int x{-8}; x <= 8; ++x)
+    {
+        for (int y{-8}; y <= 8; ++y)
+        {
+            points.push_back({{ float(x), float(y) }});
+        }
+    }
+
+    TestBlockFile(points, 16);
+}
+
+TEST(BlockFile, Empty)
+{
+    TestBlockFile(std::vector<std::array<float, 2>>(), 16);
+}
+
+TEST(BlockFile, Invalid)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> points(100, Point{{ 1.0f, 2.0f }});
+
+    auto path = testing::TempDir() + "zorder_knn_blocks.bin";
+    zorder_knn::WriteBlockFile<Point, 2>(path, points.begin(), points.end(), 16);
+
+    using Reader3 = zorder_knn::BlockFileReader<std::array<float, 3>, 3>;
+    EXPECT_THROW(Reader3 reader(path), std::runtime_error);
+
+    using Reader2d = zorder_knn::BlockFileReader<std::array<double, 2>, 2>;
+    EXPECT_THROW(Reader2d reader(path), std::runtime_error);
+
+    using Reader = zorder_knn::BlockFileReader<Point, 2>;
+
+    std::vector<unsigned char> bytes(1 << 16);
+    bytes.resize(zorder_knn::detail::File(path, "rb").Read(bytes.data(), 1,
+        bytes.size()));
+
+    auto write_header = [&](zorder_knn::BlockFileHeader const& header) {
+        auto corrupt = bytes;
+        std::memcpy(corrupt.data(), &header, sizeof(header));
+        zorder_knn::detail::File(path, "wb").Write(corrupt.data(), 1,
+            corrupt.size());
+    };
+
+    zorder_knn::BlockFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    auto zero_block_size = header;
+    zero_block_size.block_size = 0;
+    write_header(zero_block_size);
+    EXPECT_THROW(Reader reader(path), std::runtime_error);
+
+    // npoints * sizeof(Point) wraps around to a small size
+    auto huge_npoints = header;
+    huge_npoints.npoints = (uint64_t(1) << 63) / sizeof(Point) * 2 + 100;
+    write_header(huge_npoints);
+    EXPECT_THROW(Reader reader(path), std::runtime_error);
+
+    auto huge_block_size = header;
+    huge_block_size.block_size = ~uint64_t(0);
+    write_header(huge_block_size);
+    EXPECT_THROW(Reader reader(path), std::runtime_error);
+
+    write_header(header);
+    EXPECT_NO_THROW(Reader reader(path));
+
+    // truncated
+    zorder_knn::detail::File(path, "wb").Write(points.data(), sizeof(Point), 4);
+    EXPECT_THROW(Reader reader(path), std::runtime_error);
+
+    std::remove(path.c_str());
+    EXPECT_THROW(Reader reader(path), std::runtime_error);
+}
+
+#endif // ZORDER_KNN_HAS_MMAP
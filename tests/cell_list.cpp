@@ -0,0 +1,175 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/cell_list.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestCellList(std::vector<Point> const& points, std::vector<Point> const& queries,
+    double h)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+    using zorder_knn::detail::SquaredDistance;
+
+    auto hs = static_cast<Scalar>(h);
+    for (std::size_t nthreads : { 1, 3 })
+    {
+        zorder_knn::CellList<Point, d> cells(points, hs, nthreads);
+        ASSERT_EQ(cells.Size(), points.size());
+
+        // the sorted points are a permutation of the input, grouped by cell
+        auto const& sorted = cells.Points();
+        std::vector<std::size_t> ids;
+        for (std::size_t i{0}; i < sorted.size(); ++i)
+        {
+            EXPECT_EQ(sorted[i], points[cells.Index(i)]);
+            ids.push_back(cells.Index(i));
+        }
+        std::sort(ids.begin(), ids.end());
+        for (std::size_t i{0}; i < ids.size(); ++i) { EXPECT_EQ(ids[i], i); }
+
+        for (std::size_t c{0}; c < cells.NumCells(); ++c)
+        {
+            ASSERT_LT(cells.CellBegin(c), cells.CellEnd(c));
+            auto cell = cells.CellOf(sorted[cells.CellBegin(c)]);
+            EXPECT_EQ(cells.FindCell(cell), c);
+            for (auto i = cells.CellBegin(c); i < cells.CellEnd(c); ++i)
+            {
+                EXPECT_EQ(cells.CellOf(sorted[i]), cell);
+            }
+        }
+
+        for (auto const& query : queries)
+        {
+            std::vector<std::size_t> expected;
+            for (std::size_t i{0}; i < sorted.size(); ++i)
+            {
+                if (SquaredDistance<Point, d>(query, sorted[i]) <= hs * hs) expected.push_back(i);
+            }
+            EXPECT_EQ(cells.FindNeighbors(query), expected);
+        }
+
+        std::vector<std::pair<std::size_t, std::size_t>> pairs, expected;
+        std::mutex mutex;
+        cells.ForEachPair([&](std::size_t i, std::size_t j) {
+            std::lock_guard<std::mutex> lock(mutex);
+            pairs.emplace_back(i, j);
+        }, nthreads);
+        for (std::size_t i{0}; i < sorted.size(); ++i)
+        {
+            for (std::size_t j{0}; j < sorted.size(); ++j)
+            {
+                if (i != j && SquaredDistance<Point, d>(sorted[i], sorted[j]) <= hs * hs)
+                {
+                    expected.emplace_back(i, j);
+                }
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        EXPECT_EQ(pairs, expected);
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestCellListRandom(double h)
+{
+    std::vector<std::array<double, d>> points(n), queries(200);
+    test::GenerateRandomPoints(points);
+    test::GenerateRandomPoints(queries);
+
+    // duplicate points, queries beyond the points and on top of them
+    for (std::size_t i{0}; i < 50; ++i)
+    {
+        points[n - 1 - i] = points[i % 5];
+        for (auto& x : queries[i]) { x *= 4.0; }
+        queries[50 + i] = points[i];
+    }
+
+    TestCellList(points, queries, h);
+    TestCellList(test::CastDoubleToFloat(points),
+        test::CastDoubleToFloat(queries), h);
+}
+
+}
+
+TEST(CellList, Random2D_2k) { TestCellListRandom<2000, 2>(0.3); TestCellListRandom<2000, 2>(1.5); }
+TEST(CellList, Random3D_2k) { TestCellListRandom<2000, 3>(1.0); }
+TEST(CellList, Random4D_1k) { TestCellListRandom<1000, 4>(3.0); }
+
+TEST(CellList, Lattice)
+{
+    // neighbors at distance h exactly, which rounding must not lose
+    using Point = std::array<double, 3>;
+    for (double h : { 0.1, 0.3, 1.0 / 3.0 })
+    {
+        std::vector<Point> points;
+        for (int i{0}; i < 8; ++i)
+        {
+            for (int j{0}; j < 8; ++j)
+            {
+                for (int k{0}; k < 8; ++k)
+                {
+                    points.push_back({{ 0.7 + i * h, -1.0 + j * h, k * h }});
+                }
+            }
+        }
+
+        TestCellList(points, { points[100], {{ 0.7, -1.0, 0.0 }} }, h);
+    }
+}
+
+TEST(CellList, Small)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> queries = { {{ 0.0f, 0.0f }} };
+
+    TestCellList(std::vector<Point>{}, queries, 1.0);
+    TestCellList(std::vector<Point>{ {{ 1.0f, 0.0f }} }, queries, 1.0);
+    TestCellList(std::vector<Point>(10, {{ 1.0f, -1.0f }}), queries, 2.0);
+}
+
+TEST(CellList, InvalidRadius)
+{
+    using Point = std::array<float, 2>;
+    using CellList = zorder_knn::CellList<Point, 2>;
+    std::vector<Point> points(10, {{ 1.0f, -1.0f }});
+
+    EXPECT_THROW(CellList(points, 0.0f), std::invalid_argument);
+    EXPECT_THROW(CellList(points, -1.0f), std::invalid_argument);
+    EXPECT_THROW(CellList(points, std::numeric_limits<float>::quiet_NaN()),
+        std::invalid_argument);
+}
@@ -0,0 +1,248 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/compressed_points.hpp>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+bool
+BitwiseEqual(Point const& p, Point const& q)
+{
+    return std::memcmp(&p, &q, sizeof(Point)) == 0;
+}
+
+template <typename Point>
+void
+TestRoundTrip(std::vector<Point> const& points, std::size_t block_size)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    zorder_knn::CompressedPoints<Point, d> compressed(points.begin(),
+        points.end(), block_size);
+    ASSERT_EQ(compressed.Size(), points.size());
+    ASSERT_EQ(compressed.NumBlocks(),
+        (points.size() + block_size - 1) / block_size);
+
+    auto decoded = compressed.Decode();
+    ASSERT_EQ(decoded.size(), points.size());
+    for (std::size_t i{0}; i < points.size(); ++i)
+    {
+        EXPECT_TRUE(BitwiseEqual(decoded[i], points[i])) << i;
+        EXPECT_TRUE(BitwiseEqual(compressed[i], points[i])) << i;
+    }
+
+    std::vector<Point> block(block_size);
+    for (std::size_t b{0}; b < compressed.NumBlocks(); ++b)
+    {
+        auto* end = compressed.DecodeBlock(b, block.data());
+        ASSERT_EQ(static_cast<std::size_t>(end - block.data()),
+            compressed.BlockEnd(b) - compressed.BlockBegin(b));
+        for (auto i = compressed.BlockBegin(b); i < compressed.BlockEnd(b); ++i)
+        {
+            EXPECT_TRUE(BitwiseEqual(block[i - compressed.BlockBegin(b)], points[i]));
+        }
+    }
+}
+
+template <typename Point>
+std::vector<Point>
+GenerateRandomPoints(std::size_t n, double lo, double hi)
+{
+    using Scalar = typename Point::value_type;
+
+    std::mt19937 e2(42);
+    std::uniform_real_distribution<double> dist(lo, hi);
+
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = static_cast<Scalar>(dist(e2)); }
+    }
+
+    return points;
+}
+
+template <typename Point>
+void
+TestRandom()
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    auto points = GenerateRandomPoints<Point>(10000, -8.0, 8.0);
+    TestRoundTrip(points, 256);
+
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, d>());
+    for (std::size_t block_size : { 1, 7, 256, 20000 })
+    {
+        TestRoundTrip(points, block_size);
+    }
+}
+
+template <typename Scalar>
+void
+TestSpecial()
+{
+    using Point = std::array<Scalar, 2>;
+    using limits = std::numeric_limits<Scalar>;
+
+    std::vector<Scalar> values{ Scalar(0), -Scalar(0), Scalar(1), Scalar(-1),
+        limits::min(), -limits::min(), limits::denorm_min(), -limits::denorm_min(),
+        limits::max(), limits::lowest(), limits::infinity(), -limits::infinity(),
+        limits::quiet_NaN() };
+
+    std::vector<Point> points;
+    for (auto x : values)
+    {
+        for (auto y : values) { points.push_back({{ x, y }}); }
+    }
+
+    TestRoundTrip(points, 5);
+    TestRoundTrip(points, 256);
+}
+
+template <typename Int>
+void
+TestInteger()
+{
+    using Point = std::array<Int, 3>;
+    using limits = std::numeric_limits<Int>;
+
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<int64_t> dist(limits::min(), limits::max());
+
+    std::vector<Point> points(1000);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = static_cast<Int>(dist(e2)); }
+    }
+    points[0] = {{ limits::min(), limits::max(), Int(0) }};
+    points[1] = {{ limits::max(), limits::min(), Int(0) }};
+
+    TestRoundTrip(points, 64);
+}
+
+}
+
+TEST(OrderedBits, Order)
+{
+    using zorder_knn::detail::OrderedBits;
+
+    std::vector<float> values{ -std::numeric_limits<float>::infinity(), -2.0f,
+        -1.0f, -std::numeric_limits<float>::denorm_min(), -0.0f, 0.0f,
+        std::numeric_limits<float>::denorm_min(), 1.0f, 2.0f,
+        std::numeric_limits<float>::infinity() };
+    for (std::size_t i{1}; i < values.size(); ++i)
+    {
+        EXPECT_LT(OrderedBits<float>::Encode(values[i - 1]),
+            OrderedBits<float>::Encode(values[i]));
+    }
+
+    EXPECT_LT(OrderedBits<int16_t>::Encode(-32768), OrderedBits<int16_t>::Encode(-1));
+    EXPECT_LT(OrderedBits<int16_t>::Encode(-1), OrderedBits<int16_t>::Encode(0));
+    EXPECT_LT(OrderedBits<int16_t>::Encode(0), OrderedBits<int16_t>::Encode(32767));
+    EXPECT_EQ(OrderedBits<uint8_t>::Encode(200), 200u);
+}
+
+TEST(CompressedPoints, Empty)
+{
+    using Point = std::array<float, 3>;
+    std::vector<Point> points;
+
+    zorder_knn::CompressedPoints<Point, 3> compressed(points.begin(), points.end());
+    EXPECT_EQ(compressed.Size(), 0u);
+    EXPECT_EQ(compressed.NumBlocks(), 0u);
+    EXPECT_TRUE(compressed.Decode().empty());
+
+    EXPECT_THROW((zorder_knn::CompressedPoints<Point, 3>(points.begin(),
+        points.end(), 0)), std::invalid_argument);
+}
+
+TEST(CompressedPoints, Random2D) { TestRandom<std::array<float, 2>>(); TestRandom<std::array<double, 2>>(); }
+TEST(CompressedPoints, Random3D) { TestRandom<std::array<float, 3>>(); TestRandom<std::array<double, 3>>(); }
+TEST(CompressedPoints, Random7D) { TestRandom<std::array<float, 7>>(); }
+
+TEST(CompressedPoints, Special)
+{
+    TestSpecial<float>();
+    TestSpecial<double>();
+}
+
+TEST(CompressedPoints, Integer)
+{
+    TestInteger<int8_t>();
+    TestInteger<uint8_t>();
+    TestInteger<int16_t>();
+    TestInteger<uint16_t>();
+    TestInteger<int32_t>();
+    TestInteger<int64_t>();
+}
+
+TEST(CompressedPoints, ReducedPrecision)
+{
+    using PointB = std::array<zorder_knn::BFloat16, 3>;
+    std::vector<PointB> points_b(1000);
+    for (std::size_t i{0}; i < points_b.size(); ++i)
+    {
+        points_b[i] = {{ zorder_knn::BFloat16::FromBits(static_cast<uint16_t>(i * 65)),
+            zorder_knn::BFloat16(-0.5f * static_cast<float>(i)),
+            zorder_knn::BFloat16(0.0f) }};
+    }
+    TestRoundTrip(points_b, 100);
+
+#if defined(ZORDER_KNN_FLOAT16)
+    TestRandom<std::array<_Float16, 3>>();
+#endif
+}
+
+TEST(CompressedPoints, SortedCompresses)
+{
+    // millimeter grid coordinates within a 100 m cube, as LiDAR scans are
+    // commonly stored
+    using Point = std::array<int32_t, 3>;
+
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<int32_t> dist(-50000, 50000);
+
+    std::vector<Point> points(1 << 16);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = dist(e2); }
+    }
+
+    zorder_knn::CompressedPoints<Point, 3> unsorted(points.begin(), points.end());
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    zorder_knn::CompressedPoints<Point, 3> sorted(points.begin(), points.end());
+
+    EXPECT_LT(sorted.MemoryUsage(), points.size() * sizeof(Point) / 2);
+    EXPECT_LT(sorted.MemoryUsage(), unsorted.MemoryUsage());
+    TestRoundTrip(points, 256);
+}
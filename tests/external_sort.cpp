@@ -0,0 +1,180 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/external_sort.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+WritePoints(std::string const& path, std::vector<Point> const& points)
+{
+    zorder_knn::detail::File file(path, "wb");
+    file.Write(points.data(), sizeof(Point), points.size());
+    file.Close();
+}
+
+template <typename Point>
+std::vector<Point>
+ReadPoints(std::string const& path)
+{
+    zorder_knn::detail::File file(path, "rb");
+
+    std::vector<Point> points;
+    Point p;
+    while (file.Read(&p, sizeof(Point), 1) == 1) { points.push_back(p); }
+
+    return points;
+}
+
+template <typename Point>
+void
+TestExternalSort(std::vector<Point> const& points,
+    zorder_knn::ExternalSortOptions const& options)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    auto input = testing::TempDir() + "zorder_knn_points.bin";
+    auto output = testing::TempDir() + "zorder_knn_sorted.bin";
+    WritePoints(input, points);
+
+    auto stats = zorder_knn::ExternalSort<Point, d>(input, output, options);
+    EXPECT_EQ(stats.npoints, points.size());
+    EXPECT_GE(stats.io_seconds, 0.0);
+    EXPECT_GE(stats.compute_seconds, 0.0);
+
+    auto sorted = points;
+    zorder_knn::Sort<Point, d>(sorted.begin(), sorted.end());
+    EXPECT_EQ(ReadPoints<Point>(output), sorted);
+
+    // no temporary runs are left behind
+    EXPECT_EQ(std::fopen(zorder_knn::detail::RunPath(output, 0).c_str(), "rb"),
+        nullptr);
+
+    std::remove(input.c_str());
+    std::remove(output.c_str());
+}
+
+}
+
+TEST(ExternalSort, MultiplePasses)
+{
+    std::vector<std::array<double, 3>> points(20000);
+    test::GenerateRandomPoints(points);
+    auto points_float = test::CastDoubleToFloat(points);
+
+    zorder_knn::ExternalSortOptions options;
+    options.run_size = 1000;
+    options.fan_in = 3;
+    options.buffer_size = 100;
+
+    TestExternalSort(points, options);
+    TestExternalSort(points_float, options);
+
+    options.use_mmap = true;
+    TestExternalSort(points_float, options);
+}
+
+TEST(ExternalSort, SinglePass)
+{
+    std::vector<std::array<double, 2>> points(10000);
+    test::GenerateRandomPoints(points);
+
+    zorder_knn::ExternalSortOptions options;
+    options.run_size = 3000;
+    TestExternalSort(points, options);
+
+    // a single run
+    options.run_size = 10000;
+    TestExternalSort(points, options);
+}
+
+TEST(ExternalSort, Duplicates)
+{
+    using Point = std::array<float, 3>;
+    std::vector<Point> points;
+    for (int i{0}; i < 5000; ++i)
+    {
+        points.push_back({{ float(i % 7) - 3.0f, float(i % 5) * 0.5f, -0.0f }});
+    }
+
+    zorder_knn::ExternalSortOptions options;
+    options.run_size = 700;
+    options.fan_in = 2;
+    TestExternalSort(points, options);
+}
+
+TEST(ExternalSort, Empty)
+{
+    TestExternalSort(std::vector<std::array<float, 3>>(),
+        zorder_knn::ExternalSortOptions());
+}
+
+TEST(ExternalSort, MissingInput)
+{
+    using Point = std::array<float, 3>;
+    EXPECT_THROW((zorder_knn::ExternalSort<Point, 3>(
+        testing::TempDir() + "zorder_knn_missing.bin",
+        testing::TempDir() + "zorder_knn_sorted.bin")), std::runtime_error);
+}
+
+TEST(ExternalSort, PartialPoint)
+{
+    using Point = std::array<float, 3>;
+    std::vector<Point> points(1000, Point{{ 1.0f, 2.0f, 3.0f }});
+
+    auto input = testing::TempDir() + "zorder_knn_points.bin";
+    auto output = testing::TempDir() + "zorder_knn_sorted.bin";
+
+    // a trailing partial point after several runs
+    zorder_knn::detail::File file(input, "wb");
+    file.Write(points.data(), sizeof(Point), points.size());
+    file.Write(points.data(), 1, sizeof(Point) - 1);
+    file.Close();
+
+    zorder_knn::ExternalSortOptions options;
+    options.run_size = 300;
+
+    for (bool use_mmap : { false, true })
+    {
+        options.use_mmap = use_mmap;
+        EXPECT_THROW((zorder_knn::ExternalSort<Point, 3>(input, output,
+            options)), std::runtime_error);
+
+        // the runs written before the exception are removed
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            EXPECT_EQ(std::fopen(zorder_knn::detail::RunPath(output, i).c_str(),
+                "rb"), nullptr);
+        }
+    }
+
+    std::remove(input.c_str());
+}
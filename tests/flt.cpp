@@ -92,3 +92,65 @@ TEST(FloatSig, OneOverPowerOfTwo)
         EXPECT_EQ(zorder_knn::detail::FloatSig(d_uint), 0x1ll << (52 - i));
     }
 }
+
+#if defined(ZORDER_KNN_FLOAT16)
+TEST(FloatToUInt, Half)
+{
+    EXPECT_EQ(zorder_knn::detail::FloatToUInt(static_cast<_Float16>(0.0f)), 0x0u);
+    EXPECT_EQ(zorder_knn::detail::FloatToUInt(static_cast<_Float16>(-0.0f)), 0x8000u);
+    EXPECT_EQ(zorder_knn::detail::FloatToUInt(static_cast<_Float16>(1.0f)), 0x3c00u);
+    EXPECT_EQ(zorder_knn::detail::FloatToUInt(static_cast<_Float16>(
+        std::numeric_limits<float>::infinity())), 0x7c00u);
+}
+
+TEST(FloatExp, PowerOfTwoHalf)
+{
+    for (int exp(-14); exp < 16; ++exp)
+    {
+        auto h_uint = zorder_knn::detail::FloatToUInt(static_cast<_Float16>(
+            std::pow(2.0f, exp)));
+        EXPECT_EQ(zorder_knn::detail::FloatExp(h_uint), exp);
+    }
+
+    // subnormal numbers share the exponent of the smallest normal ones
+    auto h_uint = zorder_knn::detail::FloatToUInt(static_cast<_Float16>(
+        std::pow(2.0f, -20)));
+    EXPECT_EQ(zorder_knn::detail::FloatExp(h_uint), -14);
+}
+
+TEST(FloatSig, OneOverPowerOfTwoHalf)
+{
+    for (int i(10); i > 0; --i)
+    {
+        auto h_uint = zorder_knn::detail::FloatToUInt(static_cast<_Float16>(
+            1.0f + std::pow(2.0f, -i)));
+        EXPECT_EQ(zorder_knn::detail::FloatSig(h_uint), 0x1u << (10 - i));
+        EXPECT_EQ(zorder_knn::detail::FloatFullSig(h_uint), 0x400u | (0x1u << (10 - i)));
+    }
+}
+#endif
+
+TEST(BFloat16, Conversion)
+{
+    using zorder_knn::BFloat16;
+
+    EXPECT_EQ(BFloat16(0.0f).bits, 0x0000u);
+    EXPECT_EQ(BFloat16(-0.0f).bits, 0x8000u);
+    EXPECT_EQ(BFloat16(1.0f).bits, 0x3f80u);
+    EXPECT_EQ(BFloat16(-2.0f).bits, 0xc000u);
+    EXPECT_EQ(BFloat16(std::numeric_limits<float>::infinity()).bits, 0x7f80u);
+
+    // round to nearest, ties to even
+    EXPECT_EQ(BFloat16(1.0f + std::pow(2.0f, -8)).bits, 0x3f80u);
+    EXPECT_EQ(BFloat16(1.0f + std::pow(2.0f, -7) + std::pow(2.0f, -8)).bits, 0x3f82u);
+    EXPECT_EQ(BFloat16(1.0f + std::pow(2.0f, -8) + std::pow(2.0f, -10)).bits, 0x3f81u);
+
+    EXPECT_TRUE(std::isnan(static_cast<float>(BFloat16(
+        std::numeric_limits<float>::quiet_NaN()))));
+
+    for (uint32_t bits{0}; bits < 0x7f80u; bits += 0x37u)
+    {
+        auto x = BFloat16::FromBits(static_cast<uint16_t>(bits));
+        EXPECT_EQ(BFloat16(static_cast<float>(x)).bits, bits);
+    }
+}
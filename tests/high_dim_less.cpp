@@ -0,0 +1,176 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/high_dim_less.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestHighDimLess(std::vector<Point> const& points)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+
+    zorder_knn::Less<Point, d> less;
+    zorder_knn::RuntimeLess<Scalar> runtime_less{d};
+    zorder_knn::RuntimeLess<Scalar, zorder_knn::XorMsbClz> runtime_less_clz{d};
+    zorder_knn::HighDimPoints<Scalar> high_dim(points.data()->data(),
+        points.size(), d);
+    ASSERT_EQ(high_dim.Size(), points.size());
+    ASSERT_EQ(high_dim.Dim(), d);
+
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<std::size_t> index(0, points.size() - 1);
+    for (std::size_t t{0}; t < 20 * points.size(); ++t)
+    {
+        auto i = index(e2);
+        auto j = (t % 2) ? index(e2) : (i + 1) % points.size();
+
+        auto expected = less(points[i], points[j]);
+        ASSERT_EQ(runtime_less(points[i].data(), points[j].data()), expected);
+        ASSERT_EQ(runtime_less_clz(points[i].data(), points[j].data()), expected);
+        ASSERT_EQ(high_dim.Less(i, j), expected);
+    }
+
+    auto sorted(points);
+    std::sort(sorted.begin(), sorted.end(), less);
+
+    auto perm = high_dim.template SortPermutation<uint32_t>();
+    for (std::size_t i{0}; i < perm.size(); ++i)
+    {
+        EXPECT_EQ(points[perm[i]], sorted[i]);
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestHighDimLessRandom()
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    TestHighDimLess(points);
+    TestHighDimLess(test::CastDoubleToFloat(points));
+}
+
+// Points which differ from a common point in a few random coordinates
+// only, so that the comparisons are decided by the lower coordinates.
+template <std::size_t n, std::size_t d>
+void
+TestHighDimLessNear()
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<std::size_t> coordinate(0, d - 1);
+    std::uniform_int_distribution<int> ulps(-8, 8);
+    for (auto& p : points)
+    {
+        auto j = coordinate(e2);
+        auto x = points[0][j];
+        p = points[0];
+        p[j] = x + ulps(e2) * std::numeric_limits<double>::epsilon() * x;
+        if (ulps(e2) == 0) p[0] = -p[0];
+    }
+
+    TestHighDimLess(points);
+    TestHighDimLess(test::CastDoubleToFloat(points));
+}
+
+template <typename Scalar, std::size_t d>
+void
+TestHighDimLessSpecial()
+{
+    using limits = std::numeric_limits<Scalar>;
+    std::vector<Scalar> values = {
+        Scalar(0.0), -Scalar(0.0), limits::denorm_min(), -limits::denorm_min(),
+        limits::min(), -limits::min(), Scalar(1.0), Scalar(-1.5), Scalar(2.0),
+        limits::max(), limits::infinity(), -limits::infinity()
+    };
+
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<std::size_t> value(0, values.size() - 1);
+    std::uniform_int_distribution<int> spread(0, 3);
+
+    // few distinct values per point keep many coordinates equal
+    std::vector<std::array<Scalar, d>> points(1000);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = spread(e2) ? values[0] : values[value(e2)]; }
+    }
+
+    TestHighDimLess(points);
+}
+
+template <typename Int, std::size_t d>
+void
+TestHighDimLessInteger()
+{
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<int64_t> dist(std::numeric_limits<Int>::min(),
+        std::numeric_limits<Int>::max());
+
+    std::uniform_int_distribution<int> shift(0, 7);
+
+    std::vector<std::array<Int, d>> points(1000);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = static_cast<Int>(dist(e2) >> shift(e2)); }
+    }
+
+    TestHighDimLess(points);
+}
+
+}
+
+TEST(HighDimLess, Random3D_1k)   { TestHighDimLessRandom<1000, 3>(); }
+TEST(HighDimLess, Random42D_1k)  { TestHighDimLessRandom<1000, 42>(); }
+TEST(HighDimLess, Random64D_1k)  { TestHighDimLessRandom<1000, 64>(); }
+TEST(HighDimLess, Random100D_1k) { TestHighDimLessRandom<1000, 100>(); }
+TEST(HighDimLess, Random128D_1k) { TestHighDimLessRandom<1000, 128>(); }
+
+TEST(HighDimLess, Near64D_1k)  { TestHighDimLessNear<1000, 64>(); }
+TEST(HighDimLess, Near130D_1k) { TestHighDimLessNear<1000, 130>(); }
+
+TEST(HighDimLess, Special)
+{
+    TestHighDimLessSpecial<float, 64>();
+    TestHighDimLessSpecial<double, 67>();
+}
+
+TEST(HighDimLess, Integer)
+{
+    TestHighDimLessInteger<int16_t, 64>();
+    TestHighDimLessInteger<uint32_t, 70>();
+}
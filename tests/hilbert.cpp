@@ -0,0 +1,161 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/hilbert.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+// Centers of the cells of the grid [lo, lo + n)^d scaled by scale. Cell
+// centers avoid the boundaries of the cells of the curve, which belong to
+// the upper cell for non-negative and to the lower cell for negative
+// coordinates.
+template <typename Point>
+std::vector<Point>
+GenerateGrid(int lo, int n, typename Point::value_type scale)
+{
+    using Scalar = typename Point::value_type;
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    std::size_t npoints{1};
+    for (std::size_t j{0}; j < d; ++j) { npoints *= static_cast<std::size_t>(n); }
+
+    std::vector<Point> points(npoints);
+    for (std::size_t i{0}; i < npoints; ++i)
+    {
+        auto k = i;
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            points[i][j] = scale *
+                (static_cast<Scalar>(lo + static_cast<int>(k % n)) + Scalar(0.5));
+            k /= n;
+        }
+    }
+
+    return points;
+}
+
+// On a grid which covers a cell of the curve, consecutive points along
+// the Hilbert curve are neighbors. Grids of both negative and non-negative
+// coordinates span several cells of the first level.
+template <typename Point>
+void
+TestHilbertGrid(int lo, int n, typename Point::value_type scale)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    auto points = GenerateGrid<Point>(lo, n, scale);
+    std::shuffle(points.begin(), points.end(), std::mt19937(11));
+    std::sort(points.begin(), points.end(), zorder_knn::HilbertLess<Point, d>());
+
+    for (std::size_t i{1}; i < points.size(); ++i)
+    {
+        typename Point::value_type dist{0};
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            dist += std::abs(points[i][j] - points[i - 1][j]);
+        }
+
+        ASSERT_EQ(dist, scale) << "at " << i;
+    }
+}
+
+template <typename Point>
+void
+TestHilbertOrder(std::vector<Point> points)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::HilbertLess<Point, d> less;
+
+    for (std::size_t i{1}; i < points.size(); ++i)
+    {
+        EXPECT_FALSE(less(points[i], points[i]));
+        EXPECT_FALSE(less(points[i], points[i - 1]) && less(points[i - 1], points[i]));
+    }
+
+    // the order does not depend on the initial order
+    auto sorted = points;
+    std::sort(sorted.begin(), sorted.end(), less);
+    std::shuffle(points.begin(), points.end(), std::mt19937(5));
+    std::sort(points.begin(), points.end(), less);
+    EXPECT_EQ(points, sorted);
+
+    for (std::size_t i{2}; i < sorted.size(); ++i)
+    {
+        // transitivity of consecutive triples
+        if (less(sorted[i - 2], sorted[i - 1]) && less(sorted[i - 1], sorted[i]))
+        {
+            EXPECT_TRUE(less(sorted[i - 2], sorted[i]));
+        }
+    }
+}
+
+}
+
+TEST(HilbertLess, Grid2D)
+{
+    TestHilbertGrid<std::array<float, 2>>(0, 32, 1.0f);
+    TestHilbertGrid<std::array<float, 2>>(-32, 32, 1.0f);
+    TestHilbertGrid<std::array<double, 2>>(64, 64, 1.0);
+    TestHilbertGrid<std::array<double, 2>>(-16, 8, 0.125);
+    TestHilbertGrid<std::array<float, 2>>(0, 16, std::ldexp(1.0f, -130));
+}
+
+TEST(HilbertLess, Grid3D)
+{
+    TestHilbertGrid<std::array<float, 3>>(0, 16, 1.0f);
+    TestHilbertGrid<std::array<float, 3>>(-16, 16, 1.0f);
+    TestHilbertGrid<std::array<double, 3>>(-16, 8, std::ldexp(1.0, 500));
+}
+
+TEST(HilbertLess, GridHighD)
+{
+    TestHilbertGrid<std::array<float, 4>>(-8, 8, 1.0f);
+    TestHilbertGrid<std::array<double, 6>>(4, 4, 1.0);
+}
+
+TEST(HilbertLess, Random)
+{
+    std::vector<std::array<double, 3>> points(5000);
+    test::GenerateRandomPoints(points);
+
+    TestHilbertOrder(points);
+    TestHilbertOrder(test::CastDoubleToFloat(points));
+
+    std::vector<std::array<double, 2>> points2(5000);
+    test::GenerateRandomPoints(points2);
+    for (std::size_t i{0}; i < points2.size(); i += 7)
+    {
+        points2[i][i % 2] *= 1e-310;
+    }
+    points2.push_back({{ 0.0, -0.0 }});
+    points2.push_back({{ -0.0, 0.0 }});
+    TestHilbertOrder(points2);
+}
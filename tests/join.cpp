@@ -0,0 +1,108 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/join.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestJoin(std::vector<Point> a, std::vector<Point> b, double r, std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+    using zorder_knn::detail::SquaredDistance;
+
+    std::sort(a.begin(), a.end(), zorder_knn::Less<Point, d>());
+    std::sort(b.begin(), b.end(), zorder_knn::Less<Point, d>());
+
+    auto rs = static_cast<Scalar>(r);
+    std::vector<std::pair<std::size_t, std::size_t>> expected;
+    for (std::size_t i{0}; i < a.size(); ++i)
+    {
+        for (std::size_t j{0}; j < b.size(); ++j)
+        {
+            if (SquaredDistance<Point, d>(a[i], b[j]) <= rs * rs) expected.emplace_back(i, j);
+        }
+    }
+    EXPECT_EQ((zorder_knn::FindPairsWithin<Point, d>(a, b, rs)), expected);
+
+    for (auto exact : { true, false })
+    {
+        auto knn = zorder_knn::NearestJoin<Point, d>(a, b, k, exact);
+        auto kk = std::min(k, b.size());
+        ASSERT_EQ(knn.size(), a.size() * kk);
+
+        for (std::size_t i{0}; i < a.size(); ++i)
+        {
+            std::vector<std::size_t> row(knn.begin() + i * kk,
+                knn.begin() + (i + 1) * kk);
+            EXPECT_EQ(row, (zorder_knn::FindKNearest<Point, d>(b, a[i], k, exact)));
+        }
+    }
+}
+
+template <std::size_t d>
+void
+TestJoinRandom(std::size_t na, std::size_t nb, double r, std::size_t k)
+{
+    std::vector<std::array<double, d>> a(na), b(nb);
+    test::GenerateRandomPoints(a);
+    test::GenerateRandomPoints(b);
+
+    // points on top of each other and beyond the other set
+    for (std::size_t i{0}; i < std::min(na, nb) / 10; ++i)
+    {
+        a[i] = b[i];
+        for (auto& x : a[na - 1 - i]) { x *= 4.0; }
+    }
+
+    TestJoin(a, b, r, k);
+    TestJoin(test::CastDoubleToFloat(a), test::CastDoubleToFloat(b), r, k);
+}
+
+}
+
+TEST(Join, Random2D) { TestJoinRandom<2>(1000, 3000, 0.3, 1); TestJoinRandom<2>(3000, 500, 0.6, 4); }
+TEST(Join, Random3D) { TestJoinRandom<3>(2000, 2000, 1.0, 8); }
+TEST(Join, Random6D) { TestJoinRandom<6>(500, 1000, 4.0, 3); }
+
+TEST(Join, Degenerate)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> a(100, {{ 1.0f, 2.0f }}), b(50, {{ 1.0f, 2.5f }});
+
+    // equal points cannot be split into cells
+    TestJoin(a, b, 0.5, 2);
+    TestJoin(a, b, 0.25, 2);
+    TestJoin(a, {}, 1.0, 1);
+    TestJoin({}, b, 1.0, 1);
+    EXPECT_TRUE((zorder_knn::FindPairsWithin<Point, 2>(a, b, -1.0f).empty()));
+}
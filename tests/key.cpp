@@ -0,0 +1,133 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/key.hpp>
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include <array>
+#include <limits>
+
+namespace
+{
+
+// Mixture of uniformly distributed coordinates, zeros, subnormal numbers
+// and coordinates of very small and large magnitude.
+template <typename Point>
+std::vector<Point>
+GenerateSpecialPoints(std::size_t n)
+{
+    using Scalar = typename Point::value_type;
+
+    std::mt19937 e2(42);
+    std::uniform_real_distribution<Scalar> dist(-8, 8);
+    std::uniform_int_distribution<int> choice(0, 7);
+
+    auto coordinate = [&]() -> Scalar {
+        auto x = dist(e2);
+        switch (choice(e2))
+        {
+        case 0: return Scalar(0.0);
+        case 1: return -Scalar(0.0);
+        case 2: return x * std::numeric_limits<Scalar>::denorm_min();
+        case 3: return x * std::numeric_limits<Scalar>::min();
+        case 4: return x * Scalar(1e-30);
+        case 5: return x * Scalar(1e30);
+        case 6: return std::round(x);
+        default: return x;
+        }
+    };
+
+    std::vector<Point> points(n);
+    for (auto& p : points)
+    {
+        for (auto& xj : p) { xj = coordinate(); }
+    }
+
+    return points;
+}
+
+template <typename Point>
+void
+TestKeyLess(std::vector<Point> const& points)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::Less<Point, d> less;
+
+    auto layout = zorder_knn::MakeKeyLayout<Point, d>(points.begin(), points.end());
+    auto keys = zorder_knn::MakeKeys<Point, d>(layout, points.begin(), points.end());
+    ASSERT_EQ(keys.size(), points.size() * layout.nwords);
+
+    for (std::size_t i{0}; i < points.size(); ++i)
+    {
+        for (std::size_t j{0}; j < points.size(); ++j)
+        {
+            EXPECT_EQ(zorder_knn::KeyLess(
+                keys.data() + i * layout.nwords,
+                keys.data() + j * layout.nwords, layout.nwords),
+                less(points[i], points[j]));
+        }
+    }
+}
+
+template <typename Scalar, std::size_t d>
+void
+TestKeyLessSpecial()
+{
+    TestKeyLess(GenerateSpecialPoints<std::array<Scalar, d>>(300));
+}
+
+}
+
+TEST(Key, Layout)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> points{{ { 1.5f, -0.25f }, { 0.0f, 6.0f } }};
+
+    auto layout = zorder_knn::MakeKeyLayout<Point, 2>(points.begin(), points.end());
+    EXPECT_EQ(layout.bit_min, -2);
+    EXPECT_EQ(layout.bit_max, 2);
+    EXPECT_EQ(layout.nbits, 12u);
+    EXPECT_EQ(layout.nwords, 1u);
+
+    uint64_t key{0};
+    zorder_knn::MakeKey<Point, 2>(layout, points[0], &key);
+
+    // sign bits (y, x) = 01, magnitude bits x = 001.10, y = ~000.01 = 111.10
+    EXPECT_EQ(key, 0b01'10'10'11'11'00u);
+}
+
+TEST(Key, ZeroLayout)
+{
+    using Point = std::array<double, 3>;
+    std::vector<Point> points{{ { 0.0, -0.0, 0.0 } }};
+
+    auto layout = zorder_knn::MakeKeyLayout<Point, 3>(points.begin(), points.end());
+    EXPECT_EQ(layout.nbits, 6u);
+    EXPECT_EQ(layout.nwords, 1u);
+}
+
+TEST(Key, Special2D)  { TestKeyLessSpecial<float, 2>();  TestKeyLessSpecial<double, 2>(); }
+TEST(Key, Special3D)  { TestKeyLessSpecial<float, 3>();  TestKeyLessSpecial<double, 3>(); }
+TEST(Key, Special4D)  { TestKeyLessSpecial<float, 4>();  TestKeyLessSpecial<double, 4>(); }
+TEST(Key, Special42D) { TestKeyLessSpecial<float, 42>(); TestKeyLessSpecial<double, 42>(); }
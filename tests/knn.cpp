@@ -0,0 +1,185 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/knn.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+std::vector<std::size_t>
+BruteForceKnn(std::vector<Point> const& points, Point const& query,
+    std::size_t i_skip, std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+
+    std::vector<std::pair<Scalar, std::size_t>> dist;
+    for (std::size_t j{0}; j < points.size(); ++j)
+    {
+        if (j == i_skip) continue;
+        dist.emplace_back(zorder_knn::detail::SquaredDistance<Point, d>(
+            query, points[j]), j);
+    }
+    std::partial_sort(dist.begin(), dist.begin() + k, dist.end());
+
+    std::vector<std::size_t> knn(k);
+    for (std::size_t m{0}; m < k; ++m) { knn[m] = dist[m].second; }
+
+    return knn;
+}
+
+template <typename Point>
+void
+TestKnnGraph(std::vector<Point> const& points, std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    auto graph = zorder_knn::BuildKnnGraph<Point, d>(points, k);
+    ASSERT_EQ(graph.size(), points.size() * k);
+
+    for (std::size_t i{0}; i < points.size(); ++i)
+    {
+        auto knn = BruteForceKnn(points, points[i], i, k);
+        for (std::size_t m{0}; m < k; ++m)
+        {
+            EXPECT_EQ(graph[i * k + m], knn[m]);
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestKnnGraphRandom(std::size_t k)
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    TestKnnGraph(points, k);
+    TestKnnGraph(test::CastDoubleToFloat(points), k);
+}
+
+template <typename Point>
+void
+TestFindKNearest(std::vector<Point> points, std::vector<Point> const& queries,
+    std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, d>());
+
+    for (auto const& query : queries)
+    {
+        auto knn = zorder_knn::FindKNearest<Point, d>(points, query, k);
+        EXPECT_EQ(knn, BruteForceKnn(points, query, points.size(), k));
+
+        // approximate neighbors are never closer than the exact ones
+        auto approx = zorder_knn::FindKNearest<Point, d>(points, query, k, false);
+        ASSERT_EQ(approx.size(), k);
+        for (std::size_t m{0}; m < k; ++m)
+        {
+            using zorder_knn::detail::SquaredDistance;
+            auto dist2_approx = SquaredDistance<Point, d>(query, points[approx[m]]);
+            auto dist2 = SquaredDistance<Point, d>(query, points[knn[m]]);
+            EXPECT_GE(dist2_approx, dist2);
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestFindKNearestRandom(std::size_t k)
+{
+    std::vector<std::array<double, d>> points(n), queries(200);
+    test::GenerateRandomPoints(points);
+    test::GenerateRandomPoints(queries);
+
+    // queries beyond the points as well as on top of them
+    for (std::size_t i{0}; i < 50; ++i)
+    {
+        for (auto& x : queries[i]) { x *= 4.0; }
+        queries[50 + i] = points[i];
+    }
+
+    TestFindKNearest(points, queries, k);
+    TestFindKNearest(test::CastDoubleToFloat(points),
+        test::CastDoubleToFloat(queries), k);
+}
+
+}
+
+TEST(KnnGraph, Random2D_2k)  { TestKnnGraphRandom<2000, 2>(1);  TestKnnGraphRandom<2000, 2>(8); }
+TEST(KnnGraph, Random3D_2k)  { TestKnnGraphRandom<2000, 3>(10); }
+TEST(KnnGraph, Random6D_1k)  { TestKnnGraphRandom<1000, 6>(16); }
+
+TEST(KnnGraph, Grid)
+{
+    // many equidistant neighbors, ties are broken by index
+    using Point = std::array<float, 2>;
+    std::vector<Point> points;
+    for (int i{0}; i < 32; ++i)
+    {
+        for (int j{0}; j < 32; ++j)
+        {
+            points.push_back({{ float(j) - 16.0f, float(i) - 16.0f }});
+        }
+    }
+
+    TestKnnGraph(points, 4);
+    TestKnnGraph(points, 9);
+}
+
+TEST(KnnGraph, Small)
+{
+    using Point = std::array<double, 3>;
+    std::vector<Point> points(5);
+    test::GenerateRandomPoints(points);
+
+    TestKnnGraph(points, 4);
+    EXPECT_TRUE((zorder_knn::BuildKnnGraph<Point, 3>(points, 0).empty()));
+
+    // a point is not its own neighbor
+    EXPECT_THROW((zorder_knn::BuildKnnGraph<Point, 3>(points, 5)),
+        std::invalid_argument);
+    EXPECT_THROW((zorder_knn::BuildKnnGraph<Point, 3>(std::vector<Point>(), 1)),
+        std::invalid_argument);
+}
+
+TEST(FindKNearest, Random2D_2k) { TestFindKNearestRandom<2000, 2>(1); TestFindKNearestRandom<2000, 2>(8); }
+TEST(FindKNearest, Random3D_2k) { TestFindKNearestRandom<2000, 3>(10); }
+TEST(FindKNearest, Random6D_1k) { TestFindKNearestRandom<1000, 6>(16); }
+
+TEST(FindKNearest, Small)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> points = {{ {{ 1.0f, 2.0f }}, {{ -1.0f, 0.5f }}, {{ 3.0f, -2.0f }} }};
+
+    TestFindKNearest(points, {{ {{ 0.0f, 0.0f }}, {{ 10.0f, 10.0f }} }}, 3);
+    EXPECT_EQ((zorder_knn::FindKNearest<Point, 2>(points, points[0], 5).size()), 3u);
+    EXPECT_TRUE((zorder_knn::FindKNearest<Point, 2>({}, points[0], 5).empty()));
+}
@@ -0,0 +1,170 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/less.hpp>
+#include <zorder_knn/parallel_sort.hpp>
+#include <zorder_knn/sort.hpp>
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+template <typename Scalar, std::size_t d>
+std::vector<std::array<double, d>>
+Widen(std::vector<std::array<Scalar, d>> const& points)
+{
+    std::vector<std::array<double, d>> widened(points.size());
+
+    for (std::size_t i{0}; i < points.size(); ++i)
+    {
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            widened[i][j] = static_cast<double>(points[i][j]);
+        }
+    }
+
+    return widened;
+}
+
+// Points of a reduced precision type must sort exactly as their values
+// widened to double do.
+template <typename Scalar, std::size_t d>
+void
+TestLessScalar(std::vector<std::array<Scalar, d>> const& points)
+{
+    using Point = std::array<Scalar, d>;
+
+    auto expected = Widen(points);
+    std::sort(expected.begin(), expected.end(),
+        zorder_knn::Less<std::array<double, d>, d>());
+
+    auto points1(points), points2(points), points3(points), points4(points);
+    std::sort(points1.begin(), points1.end(), zorder_knn::Less<Point, d>());
+    std::sort(points2.begin(), points2.end(),
+        zorder_knn::Less<Point, d, zorder_knn::XorMsbClz>());
+    zorder_knn::Sort<Point, d>(points3.begin(), points3.end());
+    zorder_knn::ParallelSort<Point, d>(points4.begin(), points4.end(), 2);
+
+    EXPECT_EQ(Widen(points1), expected);
+    EXPECT_EQ(Widen(points2), expected);
+    EXPECT_EQ(Widen(points3), expected);
+    EXPECT_EQ(Widen(points4), expected);
+}
+
+template <typename Scalar, std::size_t d, typename Dist, typename Cast>
+std::vector<std::array<Scalar, d>>
+GeneratePoints(std::size_t n, Dist dist, Cast cast)
+{
+    std::mt19937 e2(42);
+    std::vector<std::array<Scalar, d>> points(n);
+
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = cast(dist(e2)); }
+    }
+
+    // duplicates and zeros
+    for (std::size_t i{0}; i + 1 < n; i += 97) { points[i + 1] = points[i]; }
+    points[n / 2].fill(cast(0));
+
+    return points;
+}
+
+template <typename Int, std::size_t d>
+void
+TestLessInteger(Int lo, Int hi)
+{
+    TestLessScalar(GeneratePoints<Int, d>(5000,
+        std::uniform_int_distribution<Int>(lo, hi),
+        [](Int x) { return x; }));
+}
+
+template <std::size_t d>
+void
+TestLessBFloat16()
+{
+    auto cast = [](float x) { return zorder_knn::BFloat16(x); };
+    TestLessScalar(GeneratePoints<zorder_knn::BFloat16, d>(5000,
+        std::uniform_real_distribution<float>(-8.0f, 8.0f), cast));
+    TestLessScalar(GeneratePoints<zorder_knn::BFloat16, d>(5000,
+        std::uniform_real_distribution<float>(-1e-38f, 1e-38f), cast));
+}
+
+#if defined(ZORDER_KNN_FLOAT16)
+template <std::size_t d>
+void
+TestLessHalf()
+{
+    auto cast = [](float x) { return static_cast<_Float16>(x); };
+    TestLessScalar(GeneratePoints<_Float16, d>(5000,
+        std::uniform_real_distribution<float>(-8.0f, 8.0f), cast));
+    // subnormal numbers
+    TestLessScalar(GeneratePoints<_Float16, d>(5000,
+        std::uniform_real_distribution<float>(-1e-4f, 1e-4f), cast));
+}
+#endif
+
+}
+
+TEST(Less, Int16)
+{
+    TestLessInteger<int16_t, 2>(-32768, 32767);
+    TestLessInteger<int16_t, 3>(-100, 100);
+}
+
+TEST(Less, UInt16)
+{
+    TestLessInteger<uint16_t, 3>(0, 65535);
+}
+
+TEST(Less, Int32)
+{
+    TestLessInteger<int32_t, 3>(std::numeric_limits<int32_t>::min(),
+        std::numeric_limits<int32_t>::max());
+    TestLessInteger<int32_t, 4>(-1000, 1000);
+}
+
+TEST(Less, Int64)
+{
+    // values exact in double
+    TestLessInteger<int64_t, 3>(-(int64_t(1) << 53), int64_t(1) << 53);
+}
+
+TEST(Less, BFloat16)
+{
+    TestLessBFloat16<2>();
+    TestLessBFloat16<3>();
+}
+
+#if defined(ZORDER_KNN_FLOAT16)
+TEST(Less, Half)
+{
+    TestLessHalf<2>();
+    TestLessHalf<3>();
+}
+#endif
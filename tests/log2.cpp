@@ -40,3 +40,20 @@ TEST(UIntLogBase2, PowerOfTwo)
         EXPECT_EQ(zorder_knn::detail::UIntLogBase2(2 * x - 1), i);
     }
 }
+
+TEST(UIntClzLogBase2, PowerOfTwo)
+{
+    for (int i{0}; i < 64; ++i)
+    {
+        if (i < 32)
+        {
+            uint32_t x = 0x1u << i;
+            EXPECT_EQ(zorder_knn::detail::UIntClzLogBase2(x), i);
+            EXPECT_EQ(zorder_knn::detail::UIntClzLogBase2(2 * x - 1), i);
+        }
+
+        uint64_t x = 0x1ll << i;
+        EXPECT_EQ(zorder_knn::detail::UIntClzLogBase2(x), i);
+        EXPECT_EQ(zorder_knn::detail::UIntClzLogBase2(2 * x - 1), i);
+    }
+}
@@ -0,0 +1,104 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/merge.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestMergeSorted(std::vector<std::vector<Point>> runs)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::Less<Point, d> less;
+
+    std::vector<Point> expected;
+    for (auto& run : runs)
+    {
+        std::sort(run.begin(), run.end(), less);
+        expected.insert(expected.end(), run.begin(), run.end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), less);
+
+    EXPECT_EQ((zorder_knn::MergeSorted<Point, d>(runs)), expected);
+}
+
+template <std::size_t d>
+void
+TestMergeSortedRandom(std::size_t k)
+{
+    // runs of different lengths, some of them empty
+    std::vector<std::vector<std::array<double, d>>> runs(k);
+    for (std::size_t i{0}; i < k; ++i)
+    {
+        runs[i].resize((i * 37) % 11 == 3 ? 0 : 100 + 50 * (i % 7));
+        test::GenerateRandomPoints(runs[i]);
+    }
+
+    TestMergeSorted(runs);
+
+    std::vector<std::vector<std::array<float, d>>> runs_float;
+    for (auto const& run : runs) { runs_float.push_back(test::CastDoubleToFloat(run)); }
+    TestMergeSorted(runs_float);
+}
+
+}
+
+TEST(MergeSorted, Random2D) { for (std::size_t k : { 0, 1, 2, 3, 5, 8, 13, 64 }) { TestMergeSortedRandom<2>(k); } }
+TEST(MergeSorted, Random3D) { TestMergeSortedRandom<3>(7); }
+TEST(MergeSorted, Random6D) { TestMergeSortedRandom<6>(9); }
+
+TEST(MergeSorted, Stable)
+{
+    // equal points are output in the order of their runs
+    struct TaggedPoint
+    {
+        std::array<float, 2> x;
+        std::size_t run;
+        float operator[](std::size_t j) const { return x[j]; }
+    };
+
+    std::vector<std::vector<TaggedPoint>> runs(5);
+    for (std::size_t r{0}; r < runs.size(); ++r)
+    {
+        for (int i{0}; i < 3; ++i)
+        {
+            runs[r].push_back({ {{ float(i), float(i) }}, r });
+        }
+    }
+
+    auto merged = zorder_knn::MergeSorted<TaggedPoint, 2>(runs);
+    ASSERT_EQ(merged.size(), 15u);
+    for (std::size_t i{0}; i < merged.size(); ++i)
+    {
+        EXPECT_EQ(merged[i].x, runs[0][i / 5].x);
+        EXPECT_EQ(merged[i].run, i % 5);
+    }
+}
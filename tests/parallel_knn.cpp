@@ -0,0 +1,96 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/parallel_knn.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestParallelKnnGraph(std::vector<Point> const& points, std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    auto graph = zorder_knn::BuildKnnGraph<Point, d>(points, k);
+
+    for (std::size_t nthreads : { 1, 2, 3, 8 })
+    {
+        zorder_knn::ThreadPool pool(nthreads);
+        for (std::size_t chunk_size : { 1, 7, 100, 4096 })
+        {
+            EXPECT_EQ((zorder_knn::ParallelBuildKnnGraph<Point, d>(pool,
+                points, k, chunk_size)), graph);
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestParallelKnnGraphRandom(std::size_t k)
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    TestParallelKnnGraph(points, k);
+    TestParallelKnnGraph(test::CastDoubleToFloat(points), k);
+}
+
+}
+
+TEST(ParallelKnnGraph, Random2D_2k) { TestParallelKnnGraphRandom<2000, 2>(1); TestParallelKnnGraphRandom<2000, 2>(8); }
+TEST(ParallelKnnGraph, Random3D_2k) { TestParallelKnnGraphRandom<2000, 3>(10); }
+TEST(ParallelKnnGraph, Random6D_1k) { TestParallelKnnGraphRandom<1000, 6>(16); }
+
+TEST(ParallelKnnGraph, Grid)
+{
+    // many equidistant neighbors, ties are broken by index
+    using Point = std::array<float, 2>;
+    std::vector<Point> points;
+    for (int i{0}; i < 32; ++i)
+    {
+        for (int j{0}; j < 32; ++j)
+        {
+            points.push_back({{ float(j) - 16.0f, float(i) - 16.0f }});
+        }
+    }
+
+    TestParallelKnnGraph(points, 4);
+    TestParallelKnnGraph(points, 9);
+}
+
+TEST(ParallelKnnGraph, Small)
+{
+    using Point = std::array<double, 3>;
+    std::vector<Point> points(5);
+    test::GenerateRandomPoints(points);
+
+    TestParallelKnnGraph(points, 4);
+    EXPECT_TRUE((zorder_knn::ParallelBuildKnnGraph<Point, 3>(points, 0).empty()));
+    EXPECT_THROW((zorder_knn::ParallelBuildKnnGraph<Point, 3>(points, 5)),
+        std::invalid_argument);
+}
@@ -0,0 +1,128 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/parallel_sort.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+
+namespace
+{
+
+template <typename Point>
+void
+TestParallelSort(std::vector<Point> const& points, std::size_t nthreads)
+{
+    std::vector<Point> points1(points), points2(points);
+
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::ParallelSort<Point, d>(points1.begin(), points1.end(), nthreads);
+    zorder_knn::Sort<Point, d>(points2.begin(), points2.end());
+
+    ASSERT_EQ(points1.size(), points2.size());
+    for (std::size_t i{0}; i < points1.size(); ++i)
+    {
+        for (std::size_t j{0}; j < points1[i].size(); ++j)
+        {
+            EXPECT_EQ(zorder_knn::detail::FloatToUInt(points1[i][j]),
+                      zorder_knn::detail::FloatToUInt(points2[i][j]));
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestParallelSortRandom()
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    for (std::size_t nthreads : { 1, 2, 3, 8 })
+    {
+        TestParallelSort(points, nthreads);
+        TestParallelSort(test::CastDoubleToFloat(points), nthreads);
+    }
+}
+
+}
+
+TEST(ParallelSort, Random2D_100k) { TestParallelSortRandom<100000, 2>(); }
+TEST(ParallelSort, Random3D_100k) { TestParallelSortRandom<100000, 3>(); }
+TEST(ParallelSort, Random6D_10k)  { TestParallelSortRandom<10000, 6>(); }
+TEST(ParallelSort, Random42D_1k)  { TestParallelSortRandom<1000, 42>(); }
+
+TEST(ParallelSort, Duplicates)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> points;
+    for (int i{0}; i < 100000; ++i)
+    {
+        points.push_back({{ float(i % 3), (i % 2) ? 0.0f : -0.0f }});
+    }
+
+    TestParallelSort(points, 4);
+}
+
+TEST(ParallelSort, Small)
+{
+    using Point = std::array<float, 3>;
+    for (std::size_t n : { 0, 1, 2, 33 })
+    {
+        std::vector<Point> points(n);
+        test::GenerateRandomPoints(points);
+        TestParallelSort(points, 4);
+    }
+}
+
+TEST(ThreadPool, NestedTasks)
+{
+    zorder_knn::ThreadPool pool(4);
+    std::atomic<int> count{0};
+
+    for (int i{0}; i < 16; ++i)
+    {
+        pool.Submit([&] {
+            for (int j{0}; j < 16; ++j) { pool.Submit([&] { ++count; }); }
+        });
+    }
+    pool.Wait();
+
+    EXPECT_EQ(count, 16 * 16);
+}
+
+TEST(ThreadPool, Exception)
+{
+    zorder_knn::ThreadPool pool(2);
+    pool.Submit([] { throw std::runtime_error("task"); });
+    EXPECT_THROW(pool.Wait(), std::runtime_error);
+
+    // the pool remains usable
+    int count{0};
+    pool.Submit([&] { ++count; });
+    pool.Wait();
+    EXPECT_EQ(count, 1);
+}
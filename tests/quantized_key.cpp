@@ -0,0 +1,170 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/quantized_key.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <std::size_t d>
+void
+TestMortonSpread()
+{
+    using Dim = std::integral_constant<std::size_t, d>;
+
+    std::mt19937_64 e2(17);
+    for (int i{0}; i < 1000; ++i)
+    {
+        auto x = e2() >> (64 - 64 / d);
+
+        uint64_t spread{0};
+        for (std::size_t k{0}; k < 64 / d; ++k) { spread |= ((x >> k) & 1) << (k * d); }
+
+        EXPECT_EQ(zorder_knn::detail::MortonSpread(x, Dim()), spread);
+        EXPECT_EQ(zorder_knn::detail::MortonCompact(spread, Dim()), x);
+        EXPECT_EQ(spread & ~zorder_knn::detail::MortonMask<d>(0), 0u);
+    }
+}
+
+template <typename Point, typename Key>
+void
+TestRoundTrip(unsigned bits)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+
+    std::vector<Point> points(2000);
+    test::GenerateRandomPoints(points);
+
+    zorder_knn::Box<Point> box;
+    box.lo.fill(Scalar(-8.0));
+    box.hi.fill(Scalar(8.0));
+    zorder_knn::QuantizedKeyCoder<Point, d, Key> coder(box, bits);
+
+    auto cell = std::ldexp(16.0, -static_cast<int>(coder.Bits()));
+    for (auto const& p : points)
+    {
+        auto key = coder.Encode(p);
+        auto c = coder.Decode(key);
+        EXPECT_EQ(coder.Encode(c), key);
+
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            EXPECT_LE(std::abs(static_cast<double>(c[j]) - static_cast<double>(p[j])),
+                0.5 * cell + 1e-6 * std::abs(static_cast<double>(p[j])));
+        }
+    }
+}
+
+template <std::size_t d>
+void
+TestLessOrder()
+{
+    // the grid cells of the cube [0, 16]^d are cells of the z-order
+    using Point = std::array<double, d>;
+    std::vector<Point> points(2000);
+    test::GenerateRandomPoints(points);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x = std::abs(x) * 2.0; }
+    }
+
+    zorder_knn::Box<Point> box;
+    box.lo.fill(0.0);
+    box.hi.fill(16.0);
+    zorder_knn::QuantizedKeyCoder<Point, d> coder(box);
+    zorder_knn::QuantizedKeyCoder<Point, d, zorder_knn::QuantizedKey128> coder128(box);
+
+    zorder_knn::Less<Point, d> less;
+    for (std::size_t i{1}; i < points.size(); ++i)
+    {
+        auto const& p = points[i - 1];
+        auto const& q = points[i];
+
+        auto kp = coder.Encode(p), kq = coder.Encode(q);
+        if (kp != kq) { EXPECT_EQ(kp < kq, less(p, q)); }
+
+        auto kp128 = coder128.Encode(p), kq128 = coder128.Encode(q);
+        if (!(kp128 == kq128)) { EXPECT_EQ(kp128 < kq128, less(p, q)); }
+
+        // the 128-bit key refines the 64-bit key
+        if (kp < kq) { EXPECT_TRUE(kp128 < kq128); }
+    }
+}
+
+}
+
+TEST(QuantizedKey, MortonSpread)
+{
+    TestMortonSpread<2>();
+    TestMortonSpread<3>();
+    TestMortonSpread<4>();
+    TestMortonSpread<7>();
+}
+
+TEST(QuantizedKey, RoundTrip)
+{
+    TestRoundTrip<std::array<float, 2>, uint64_t>(32);
+    TestRoundTrip<std::array<double, 3>, uint64_t>(21);
+    TestRoundTrip<std::array<double, 3>, uint64_t>(10);
+    TestRoundTrip<std::array<double, 4>, uint64_t>(16);
+    TestRoundTrip<std::array<double, 3>, zorder_knn::QuantizedKey128>(42);
+    TestRoundTrip<std::array<double, 2>, zorder_knn::QuantizedKey128>(50);
+
+    // 128 / d bits per axis exceed the 64 / d bits of each word, the bits
+    // are clamped to 2 * (64 / d)
+    TestRoundTrip<std::array<double, 5>, zorder_knn::QuantizedKey128>(64);
+    TestRoundTrip<std::array<double, 6>, zorder_knn::QuantizedKey128>(64);
+    EXPECT_EQ((zorder_knn::QuantizedKeyCoder<std::array<double, 5>, 5,
+        zorder_knn::QuantizedKey128>::max_bits), 24u);
+}
+
+TEST(QuantizedKey, Clamp)
+{
+    using Point = std::array<float, 2>;
+    zorder_knn::QuantizedKeyCoder<Point, 2> coder({ {{ 0.0f, 0.0f }}, {{ 1.0f, 2.0f }} }, 4);
+
+    uint64_t q[2];
+    coder.Quantize({{ -1.0f, 5.0f }}, q);
+    EXPECT_EQ(q[0], 0u);
+    EXPECT_EQ(q[1], 15u);
+
+    coder.Quantize({{ 1.0f, 1.0f }}, q);
+    EXPECT_EQ(q[0], 15u);
+    EXPECT_EQ(q[1], 8u);
+
+    EXPECT_EQ(coder.Encode({{ 1.0f, 1.0f }}), 0xd5u);
+}
+
+TEST(QuantizedKey, LessOrder)
+{
+    TestLessOrder<3>();
+    TestLessOrder<5>();
+    TestLessOrder<6>();
+}
@@ -0,0 +1,150 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/radix_tree.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+// Range of leaves below the node, checking that the leaves are contiguous
+// and lie within the box of the node.
+template <typename Point, std::size_t d>
+std::pair<std::size_t, std::size_t>
+CheckNode(zorder_knn::RadixTree<Point, d> const& tree,
+    std::vector<Point> const& points, std::size_t node)
+{
+    using Tree = zorder_knn::RadixTree<Point, d>;
+    if (node & Tree::leaf_bit)
+    {
+        auto i = node & ~Tree::leaf_bit;
+        return { i, i + 1 };
+    }
+
+    auto left = CheckNode(tree, points, tree.Left(node));
+    auto right = CheckNode(tree, points, tree.Right(node));
+    EXPECT_EQ(left.second, right.first);
+
+    auto const& box = tree.NodeBox(node);
+    for (auto i = left.first; i < right.second; ++i)
+    {
+        EXPECT_TRUE((zorder_knn::detail::Contains<Point, d>(box, points[i])));
+    }
+
+    return { left.first, right.second };
+}
+
+template <typename Point>
+void
+TestRadixTree(std::vector<Point> points, std::vector<Point> const& queries,
+    double r, std::size_t k)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    using Scalar = typename Point::value_type;
+    using zorder_knn::detail::SquaredDistance;
+
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, d>());
+
+    for (std::size_t nthreads : { 1, 3 })
+    {
+        zorder_knn::RadixTree<Point, d> tree(points, nthreads);
+        ASSERT_EQ(tree.Size(), points.size());
+        if (points.empty()) continue;
+
+        ASSERT_EQ(tree.NumInternalNodes(), points.size() - 1);
+        auto range = CheckNode(tree, points, tree.Root());
+        EXPECT_EQ(range.first, 0u);
+        EXPECT_EQ(range.second, points.size());
+
+        auto rs = static_cast<Scalar>(r);
+        for (auto const& query : queries)
+        {
+            std::vector<std::size_t> within;
+            for (std::size_t i{0}; i < points.size(); ++i)
+            {
+                if (SquaredDistance<Point, d>(query, points[i]) <= rs * rs) within.push_back(i);
+            }
+            EXPECT_EQ(tree.FindWithin(query, rs), within);
+
+            EXPECT_EQ(tree.FindKNearest(query, k),
+                (zorder_knn::FindKNearest<Point, d>(points, query, k)));
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestRadixTreeRandom(double r, std::size_t k)
+{
+    std::vector<std::array<double, d>> points(n), queries(200);
+    test::GenerateRandomPoints(points);
+    test::GenerateRandomPoints(queries);
+
+    // duplicate points, queries beyond the points and on top of them
+    for (std::size_t i{0}; i < 50; ++i)
+    {
+        points[n - 1 - i] = points[i % 5];
+        for (auto& x : queries[i]) { x *= 4.0; }
+        queries[50 + i] = points[i];
+    }
+
+    TestRadixTree(points, queries, r, k);
+    TestRadixTree(test::CastDoubleToFloat(points),
+        test::CastDoubleToFloat(queries), r, k);
+}
+
+}
+
+TEST(RadixTree, Random2D_2k) { TestRadixTreeRandom<2000, 2>(0.3, 1); TestRadixTreeRandom<2000, 2>(0.6, 8); }
+TEST(RadixTree, Random3D_2k) { TestRadixTreeRandom<2000, 3>(1.0, 10); }
+TEST(RadixTree, Random6D_1k) { TestRadixTreeRandom<1000, 6>(4.0, 16); }
+
+TEST(RadixTree, Grid)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> points;
+    for (int i{0}; i < 32; ++i)
+    {
+        for (int j{0}; j < 32; ++j)
+        {
+            points.push_back({{ float(j) - 16.0f, float(i) - 16.0f }});
+        }
+    }
+
+    TestRadixTree(points, { {{ 0.5f, 0.5f }}, {{ -16.0f, 3.0f }}, {{ 40.0f, 0.0f }} }, 2.0, 9);
+}
+
+TEST(RadixTree, Small)
+{
+    using Point = std::array<float, 2>;
+    std::vector<Point> queries = { {{ 0.0f, 0.0f }} };
+
+    TestRadixTree(std::vector<Point>{}, queries, 1.0, 1);
+    TestRadixTree(std::vector<Point>{ {{ 1.0f, 0.0f }} }, queries, 1.0, 2);
+    TestRadixTree(std::vector<Point>(10, {{ 1.0f, -1.0f }}), queries, 2.0, 3);
+}
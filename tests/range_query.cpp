@@ -0,0 +1,149 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/range_query.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+std::vector<zorder_knn::Box<Point>>
+GenerateRandomBoxes(std::size_t n, typename Point::value_type bound)
+{
+    using Scalar = typename Point::value_type;
+
+    std::mt19937 e2(13);
+    std::uniform_real_distribution<Scalar> dist(-bound, bound);
+
+    std::vector<zorder_knn::Box<Point>> boxes(n);
+    for (auto& box : boxes)
+    {
+        for (std::size_t j{0}; j < box.lo.size(); ++j)
+        {
+            auto x0 = dist(e2), x1 = dist(e2);
+            box.lo[j] = std::min(x0, x1);
+            box.hi[j] = std::max(x0, x1);
+        }
+    }
+
+    return boxes;
+}
+
+template <typename Point>
+void
+TestFindInBox(std::vector<Point> points,
+    std::vector<zorder_knn::Box<Point>> const& boxes)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::Less<Point, d> less;
+    std::sort(points.begin(), points.end(), less);
+
+    for (auto const& box : boxes)
+    {
+        std::vector<std::size_t> expected;
+        for (std::size_t i{0}; i < points.size(); ++i)
+        {
+            if (zorder_knn::detail::Contains<Point, d>(box, points[i]))
+                expected.push_back(i);
+        }
+
+        EXPECT_EQ((zorder_knn::FindInBox<Point, d>(points, box)), expected);
+
+        // the points within the z-range of the box but outside of it
+        for (auto const& p : points)
+        {
+            if (less(p, box.lo) || less(box.hi, p)) continue;
+
+            auto bigmin = zorder_knn::BigMin<Point, d>(p, box);
+            auto litmax = zorder_knn::LitMax<Point, d>(p, box);
+            EXPECT_TRUE((zorder_knn::detail::Contains<Point, d>(box, bigmin)));
+            EXPECT_TRUE((zorder_knn::detail::Contains<Point, d>(box, litmax)));
+            EXPECT_FALSE(less(bigmin, p));
+            EXPECT_FALSE(less(p, litmax));
+
+            // no point within the box lies between litmax and bigmin
+            for (auto i : expected)
+            {
+                EXPECT_FALSE(less(points[i], bigmin) && less(litmax, points[i]));
+            }
+        }
+    }
+}
+
+}
+
+TEST(RangeQuery, Random)
+{
+    std::vector<std::array<double, 3>> points(2000);
+    test::GenerateRandomPoints(points);
+
+    TestFindInBox(points, GenerateRandomBoxes<std::array<double, 3>>(20, 8.0));
+    TestFindInBox(test::CastDoubleToFloat(points),
+        GenerateRandomBoxes<std::array<float, 3>>(20, 8.0f));
+}
+
+TEST(RangeQuery, Small)
+{
+    // many boxes contain a single point or none
+    using Point = std::array<float, 2>;
+    std::vector<Point> points(3000);
+    test::GenerateRandomPoints(points);
+
+    TestFindInBox(points, GenerateRandomBoxes<Point>(50, 0.5f));
+    TestFindInBox(points, GenerateRandomBoxes<Point>(20, 8.0f));
+}
+
+TEST(RangeQuery, Grid)
+{
+    // points on the faces of the boxes, duplicates and signed zeros
+    using Point = std::array<float, 2>;
+    std::vector<Point> points;
+    for (int x{-6}; x <= 6; ++x)
+    {
+        for (int y{-6}; y <= 6; ++y)
+        {
+            points.push_back({{ 0.5f * float(x), 0.5f * float(y) }});
+            points.push_back({{ 0.5f * float(x), 0.5f * float(y) }});
+        }
+    }
+    points.push_back({{ -0.0f, -0.0f }});
+    points.push_back({{ -0.0f, 1.0f }});
+
+    std::vector<zorder_knn::Box<Point>> boxes = {
+        { {{ -1.0f, -1.0f }}, {{ 1.0f, 1.0f }} },
+        { {{ 0.0f, 0.0f }}, {{ 0.0f, 0.0f }} },
+        { {{ -0.0f, -2.5f }}, {{ 0.5f, -0.0f }} },
+        { {{ -3.0f, 0.5f }}, {{ -0.5f, 2.5f }} },
+        { {{ 1.5f, -3.0f }}, {{ 1.5f, 3.0f }} },
+        { {{ -10.0f, -10.0f }}, {{ 10.0f, 10.0f }} },
+        { {{ 0.25f, 0.25f }}, {{ 0.4f, 0.4f }} }
+    };
+
+    TestFindInBox(points, boxes);
+}
@@ -0,0 +1,145 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/resort.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<double, 3>;
+
+std::vector<Point>
+GenerateSortedPoints(std::size_t n)
+{
+    std::vector<Point> points(n);
+    test::GenerateRandomPoints(points);
+    zorder_knn::Sort<Point, 3>(points.begin(), points.end());
+
+    return points;
+}
+
+void
+Displace(std::vector<Point>& points, double delta)
+{
+    std::mt19937 e2(5);
+    std::uniform_real_distribution<double> dist(-delta, delta);
+    for (auto& p : points)
+    {
+        for (auto& x : p) { x += dist(e2); }
+    }
+}
+
+void
+TestResort(std::vector<Point> points, zorder_knn::ResortMethod method,
+    zorder_knn::ResortOptions const& options = zorder_knn::ResortOptions())
+{
+    auto sorted = points;
+    zorder_knn::Sort<Point, 3>(sorted.begin(), sorted.end());
+
+    EXPECT_EQ((zorder_knn::Resort<Point, 3>(points.begin(), points.end(),
+        zorder_knn::detail::Identity(), options)), method);
+    EXPECT_EQ(points, sorted);
+}
+
+}
+
+TEST(Resort, Sorted)
+{
+    auto points = GenerateSortedPoints(5000);
+    TestResort(points, zorder_knn::ResortMethod::None);
+
+    TestResort({}, zorder_knn::ResortMethod::None);
+    TestResort({ {{ 1.0, 2.0, 3.0 }} }, zorder_knn::ResortMethod::None);
+}
+
+TEST(Resort, Merge)
+{
+    auto points = GenerateSortedPoints(5000);
+    auto more = GenerateSortedPoints(3000);
+    points.insert(points.end(), more.begin(), more.end());
+    TestResort(points, zorder_knn::ResortMethod::Merge);
+
+    // a few points moved far
+    points = GenerateSortedPoints(5000);
+    for (std::size_t i{0}; i < 20; ++i)
+    {
+        std::swap(points[i * 97], points[4999 - i * 101]);
+    }
+    TestResort(points, zorder_knn::ResortMethod::Merge);
+}
+
+TEST(Resort, Insertion)
+{
+    auto points = GenerateSortedPoints(5000);
+    Displace(points, 1e-2);
+    TestResort(points, zorder_knn::ResortMethod::Insertion);
+
+    zorder_knn::ResortOptions options;
+    options.max_runs = 0;
+    points = GenerateSortedPoints(5000);
+    std::swap(points[10], points[11]);
+    TestResort(points, zorder_knn::ResortMethod::Insertion, options);
+}
+
+TEST(Resort, Sort)
+{
+    auto points = GenerateSortedPoints(5000);
+    Displace(points, 1.0);
+    TestResort(points, zorder_knn::ResortMethod::Sort);
+
+    std::shuffle(points.begin(), points.end(), std::mt19937(3));
+    TestResort(points, zorder_knn::ResortMethod::Sort);
+}
+
+TEST(Resort, Projection)
+{
+    struct Particle
+    {
+        Point x;
+        int id;
+    };
+
+    auto points = GenerateSortedPoints(2000);
+    Displace(points, 1e-2);
+
+    std::vector<Particle> particles;
+    for (std::size_t i{0}; i < points.size(); ++i)
+    {
+        particles.push_back({ points[i], static_cast<int>(i) });
+    }
+
+    zorder_knn::Resort<Point, 3>(particles.begin(), particles.end(), &Particle::x);
+
+    zorder_knn::Less<Point, 3> less;
+    for (std::size_t i{0}; i < particles.size(); ++i)
+    {
+        EXPECT_EQ(particles[i].x, points[particles[i].id]);
+        if (i > 0) { EXPECT_FALSE(less(particles[i].x, particles[i - 1].x)); }
+    }
+}
@@ -0,0 +1,119 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/shard_sort.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+// Sort the shards, each one by a thread, and compare their concatenation
+// with the sorted points of all shards.
+template <typename Point>
+std::vector<zorder_knn::ShardSortStats>
+TestShardSort(std::vector<std::vector<Point>> shards)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+
+    std::vector<Point> expected;
+    for (auto const& shard : shards)
+    {
+        expected.insert(expected.end(), shard.begin(), shard.end());
+    }
+    zorder_knn::Sort<Point, d>(expected.begin(), expected.end());
+
+    zorder_knn::LoopbackHub hub(shards.size());
+    std::vector<zorder_knn::ShardSortStats> stats(shards.size());
+    std::vector<std::thread> threads;
+    for (std::size_t r{0}; r < shards.size(); ++r)
+    {
+        threads.emplace_back([&, r] {
+            zorder_knn::LoopbackTransport transport(hub, r);
+            stats[r] = zorder_knn::ShardSort<Point, d>(transport, shards[r]);
+        });
+    }
+    for (auto& t : threads) { t.join(); }
+
+    std::vector<Point> sorted;
+    for (std::size_t r{0}; r < shards.size(); ++r)
+    {
+        EXPECT_EQ(stats[r].shard_size, shards[r].size());
+        EXPECT_EQ(stats[r].imbalance, stats[0].imbalance);
+        sorted.insert(sorted.end(), shards[r].begin(), shards[r].end());
+    }
+    EXPECT_EQ(sorted, expected);
+
+    return stats;
+}
+
+template <std::size_t d>
+void
+TestShardSortRandom(std::size_t nshards)
+{
+    // shards of different sizes, one of them empty
+    std::vector<std::vector<std::array<double, d>>> shards(nshards);
+    for (std::size_t r{0}; r < nshards; ++r)
+    {
+        shards[r].resize(r == 1 ? 0 : 2000 + 1000 * r);
+        test::GenerateRandomPoints(shards[r]);
+    }
+
+    auto stats = TestShardSort(shards);
+    EXPECT_LT(stats[0].imbalance, 1.5);
+
+    std::vector<std::vector<std::array<float, d>>> shards_float;
+    for (auto const& shard : shards)
+    {
+        shards_float.push_back(test::CastDoubleToFloat(shard));
+    }
+    TestShardSort(shards_float);
+}
+
+}
+
+TEST(ShardSort, Random2D) { for (std::size_t p : { 1, 2, 3, 5 }) { TestShardSortRandom<2>(p); } }
+TEST(ShardSort, Random3D) { for (std::size_t p : { 1, 4 }) { TestShardSortRandom<3>(p); } }
+TEST(ShardSort, Random6D) { TestShardSortRandom<6>(3); }
+
+TEST(ShardSort, Duplicates)
+{
+    // equal points stay on one shard
+    using Point = std::array<float, 2>;
+    std::vector<std::vector<Point>> shards(4, std::vector<Point>(100, {{ 1.0f, -2.0f }}));
+
+    auto stats = TestShardSort(shards);
+    EXPECT_EQ(stats[0].max_shard_size, 400u);
+    EXPECT_EQ(stats[0].min_shard_size, 0u);
+    EXPECT_EQ(stats[0].imbalance, 4.0);
+}
+
+TEST(ShardSort, Empty)
+{
+    using Point = std::array<float, 3>;
+    auto stats = TestShardSort(std::vector<std::vector<Point>>(3));
+    EXPECT_EQ(stats[0].imbalance, 1.0);
+}
@@ -0,0 +1,158 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/simd_less.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+// Points with coordinates drawn from values that exercise the exponent
+// and significand special cases.
+template <typename Scalar, std::size_t d>
+std::vector<std::array<Scalar, d>>
+SpecialPoints()
+{
+    using limits = std::numeric_limits<Scalar>;
+    std::vector<Scalar> values = {
+        Scalar(0.0), -Scalar(0.0), limits::denorm_min(), -limits::denorm_min(),
+        limits::min(), -limits::min(), limits::min() - limits::denorm_min(),
+        Scalar(1.0), Scalar(-1.5), Scalar(1.75), Scalar(2.0), Scalar(-3.0),
+        limits::max(), -limits::max(), limits::infinity(), -limits::infinity()
+    };
+
+    std::vector<std::array<Scalar, d>> points;
+    for (std::size_t i{0}; i < 4000; ++i)
+    {
+        std::array<Scalar, d> p;
+        auto m = i;
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            p[j] = values[m % values.size()];
+            m = m / values.size() + i * 7;
+        }
+        points.push_back(p);
+    }
+
+    return points;
+}
+
+template <typename Point>
+void
+TestSimdLess(std::vector<Point> const& points)
+{
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::Less<Point, d> less;
+    zorder_knn::SimdLess<Point, d> simd_less;
+
+    std::vector<bool> expected_less, expected_greater;
+    std::unique_ptr<bool[]> out_less(new bool[points.size()]);
+    std::unique_ptr<bool[]> out_greater(new bool[points.size()]);
+
+    for (std::size_t i{0}; i < points.size(); i += 97)
+    {
+        auto const& pivot = points[i];
+        zorder_knn::LessBatch<Point, d>(points.data(), points.size(), pivot,
+            out_less.get());
+        zorder_knn::GreaterBatch<Point, d>(points.data(), points.size(), pivot,
+            out_greater.get());
+
+        for (std::size_t j{0}; j < points.size(); ++j)
+        {
+            ASSERT_EQ(simd_less(points[j], pivot), less(points[j], pivot));
+            ASSERT_EQ(simd_less(pivot, points[j]), less(pivot, points[j]));
+            ASSERT_EQ(out_less[j], less(points[j], pivot));
+            ASSERT_EQ(out_greater[j], less(pivot, points[j]));
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestSimdLessRandom()
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    TestSimdLess(points);
+    TestSimdLess(test::CastDoubleToFloat(points));
+}
+
+template <std::size_t d>
+void
+TestSimdLessSpecial()
+{
+    TestSimdLess(SpecialPoints<float, d>());
+    TestSimdLess(SpecialPoints<double, d>());
+}
+
+}
+
+TEST(SimdLess, Random2D_4k)  { TestSimdLessRandom<4000, 2>(); }
+TEST(SimdLess, Random3D_4k)  { TestSimdLessRandom<4000, 3>(); }
+TEST(SimdLess, Random4D_4k)  { TestSimdLessRandom<4000, 4>(); }
+TEST(SimdLess, Random6D_4k)  { TestSimdLessRandom<4000, 6>(); }
+TEST(SimdLess, Random42D_1k) { TestSimdLessRandom<1000, 42>(); }
+
+TEST(SimdLess, Special2D) { TestSimdLessSpecial<2>(); }
+TEST(SimdLess, Special3D) { TestSimdLessSpecial<3>(); }
+TEST(SimdLess, Special4D) { TestSimdLessSpecial<4>(); }
+
+#if defined(ZORDER_KNN_SIMD_AVX2) && defined(ZORDER_KNN_SIMD_AVX512)
+namespace
+{
+
+template <typename Isa>
+void
+TestBatchLess()
+{
+    using Point = std::array<typename Isa::Scalar, 3>;
+    auto points = SpecialPoints<typename Isa::Scalar, 3>();
+    zorder_knn::Less<Point, 3> less;
+
+    for (std::size_t i{0}; i + Isa::width <= points.size(); i += Isa::width)
+    {
+        auto const& pivot = points[i / 2];
+        auto mask = zorder_knn::detail::simd::BatchLess<Isa, Point, 3>(
+            points.data() + i, pivot, false);
+        for (std::size_t l{0}; l < Isa::width; ++l)
+        {
+            EXPECT_EQ(((mask >> l) & 1) != 0, less(points[i + l], pivot));
+        }
+    }
+}
+
+}
+
+// the batch comparison defaults to AVX-512, test AVX2 separately
+TEST(SimdLess, Avx2Batch)
+{
+    TestBatchLess<zorder_knn::detail::simd::Avx2Float>();
+    TestBatchLess<zorder_knn::detail::simd::Avx2Double>();
+}
+#endif
@@ -0,0 +1,102 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/soa.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Scalar, std::size_t d>
+void
+TestSoaSort(std::vector<std::array<Scalar, d>> const& points)
+{
+    using Point = std::array<Scalar, d>;
+    auto n = points.size();
+
+    std::array<std::vector<Scalar>, d> columns;
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        for (auto const& p : points) { columns[j].push_back(p[j]); }
+    }
+
+    zorder_knn::SoaPoints<Scalar, d> soa{ {}, n };
+    zorder_knn::SoaPoints<Scalar const, d> soa_const{ {}, n };
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        soa.columns[j] = columns[j].data();
+        soa_const.columns[j] = columns[j].data();
+    }
+
+    auto layout = zorder_knn::MakeKeyLayout<Point, d>(points.begin(), points.end());
+    auto keys = zorder_knn::MakeKeys<Point, d>(layout, points.begin(), points.end());
+    EXPECT_EQ(zorder_knn::MakeKeys(zorder_knn::MakeKeyLayout(soa_const), soa_const), keys);
+
+    auto perm = zorder_knn::SortPermutation<Point, d>(points.begin(), points.end());
+    EXPECT_EQ(zorder_knn::SortPermutation(soa_const), perm);
+
+    std::vector<std::size_t> indices(n);
+    std::iota(indices.begin(), indices.end(), std::size_t(0));
+    std::stable_sort(indices.begin(), indices.end(),
+        zorder_knn::SoaLess<Scalar const, d>(soa_const));
+    EXPECT_EQ(indices, perm);
+
+    zorder_knn::Sort(soa);
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            EXPECT_EQ(columns[j][i], points[perm[i]][j]);
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestSoaSortRandom()
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    TestSoaSort(points);
+    TestSoaSort(test::CastDoubleToFloat(points));
+}
+
+}
+
+TEST(Soa, Random2D_10k)  { TestSoaSortRandom<10000, 2>(); }
+TEST(Soa, Random3D_10k)  { TestSoaSortRandom<10000, 3>(); }
+TEST(Soa, Random42D_1k)  { TestSoaSortRandom<1000, 42>(); }
+
+TEST(Soa, Empty)
+{
+    std::vector<float> x, y;
+    zorder_knn::SoaPoints<float, 2> soa{ {{ x.data(), y.data() }}, 0 };
+    zorder_knn::Sort(soa);
+    EXPECT_TRUE(zorder_knn::SortPermutation(soa).empty());
+}
@@ -0,0 +1,191 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/sort.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+template <typename Point>
+void
+TestSortRandom(std::vector<Point> const& points)
+{
+    std::vector<Point> points1(points), points2(points), points3(points);
+
+    constexpr std::size_t d = std::tuple_size<Point>::value;
+    zorder_knn::Sort<Point, d>(points1.begin(), points1.end());
+    std::sort(points2.begin(), points2.end(), zorder_knn::Less<Point, d>());
+    test::SortZOrder(points3);
+
+    for (std::size_t i{0}; i < points1.size(); ++i)
+    {
+        for (std::size_t j{0}; j < points1[i].size(); ++j)
+        {
+            EXPECT_EQ(points1[i][j], points2[i][j]);
+            EXPECT_EQ(points1[i][j], points3[i][j]);
+        }
+    }
+}
+
+template <std::size_t n, std::size_t d>
+void
+TestSortRandom()
+{
+    std::vector<std::array<double, d>> points(n);
+    test::GenerateRandomPoints(points);
+
+    TestSortRandom(points);
+    TestSortRandom(test::CastDoubleToFloat(points));
+}
+
+}
+
+TEST(Sort, Random2D_10k)  { TestSortRandom<10000, 2>(); }
+TEST(Sort, Random3D_10k)  { TestSortRandom<10000, 3>(); }
+TEST(Sort, Random4D_10k)  { TestSortRandom<10000, 4>(); }
+TEST(Sort, Random6D_10k)  { TestSortRandom<10000, 6>(); }
+TEST(Sort, Random42D_10k) { TestSortRandom<10000, 42>(); }
+
+TEST(Sort, Duplicates)
+{
+    using Point = std::array<float, 3>;
+    std::vector<Point> points;
+    for (int i{0}; i < 1000; ++i)
+    {
+        points.push_back({{ float(i % 7) - 3.0f, float(i % 5) * 0.5f, -0.0f }});
+    }
+
+    auto sorted = points;
+    zorder_knn::Sort<Point, 3>(sorted.begin(), sorted.end());
+    EXPECT_TRUE(std::is_sorted(sorted.begin(), sorted.end(),
+        zorder_knn::Less<Point, 3>()));
+    EXPECT_TRUE(std::is_permutation(sorted.begin(), sorted.end(), points.begin()));
+}
+
+TEST(Sort, Empty)
+{
+    using Point = std::array<double, 2>;
+    std::vector<Point> points;
+    zorder_knn::Sort<Point, 2>(points.begin(), points.end());
+    EXPECT_TRUE(points.empty());
+}
+
+namespace
+{
+
+using Point3 = std::array<float, 3>;
+
+struct Record
+{
+    Point3 position;
+    int id;
+    char payload[100];
+
+    Point3 const& Position() const { return position; }
+};
+
+std::vector<Record>
+GenerateRecords(std::size_t n)
+{
+    std::vector<std::array<double, 3>> points(n);
+    test::GenerateRandomPoints(points);
+    auto points_float = test::CastDoubleToFloat(points);
+
+    std::vector<Record> records(n);
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        records[i].position = points_float[i];
+        records[i].id = static_cast<int>(i);
+    }
+
+    return records;
+}
+
+}
+
+TEST(SortPermutation, Projection)
+{
+    auto records = GenerateRecords(10000);
+
+    std::vector<Point3> points;
+    for (auto const& r : records) { points.push_back(r.position); }
+    auto perm = zorder_knn::SortPermutation<Point3, 3>(points.begin(), points.end());
+
+    auto perm_member = zorder_knn::SortPermutation<Point3, 3>(
+        records.begin(), records.end(), &Record::position);
+    auto perm_function = zorder_knn::SortPermutation<Point3, 3, uint32_t>(
+        records.begin(), records.end(), &Record::Position);
+    auto perm_lambda = zorder_knn::SortPermutation<Point3, 3, uint32_t>(
+        records.begin(), records.end(), [](Record const& r) { return r.position; });
+
+    ASSERT_EQ(perm_member.size(), perm.size());
+    ASSERT_EQ(perm_function.size(), perm.size());
+    ASSERT_EQ(perm_lambda.size(), perm.size());
+    for (std::size_t i{0}; i < perm.size(); ++i)
+    {
+        EXPECT_EQ(perm_member[i], perm[i]);
+        EXPECT_EQ(perm_function[i], perm[i]);
+        EXPECT_EQ(perm_lambda[i], perm[i]);
+    }
+
+    zorder_knn::Sort<Point3, 3>(records.begin(), records.end(), &Record::position);
+    for (std::size_t i{0}; i < perm.size(); ++i)
+    {
+        EXPECT_EQ(records[i].id, static_cast<int>(perm[i]));
+    }
+}
+
+TEST(ApplyPermutation, SeveralArrays)
+{
+    constexpr std::size_t n = 10000;
+
+    std::vector<Point3> points;
+    for (auto const& r : GenerateRecords(n)) { points.push_back(r.position); }
+    auto perm = zorder_knn::SortPermutation<Point3, 3, uint32_t>(points.begin(),
+        points.end());
+
+    std::vector<int> ids(n);
+    std::vector<std::string> names(n);
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        ids[i] = static_cast<int>(i);
+        names[i] = std::to_string(i);
+    }
+
+    auto sorted = points;
+    zorder_knn::Sort<Point3, 3>(sorted.begin(), sorted.end());
+
+    zorder_knn::ApplyPermutation(perm, points, ids, names);
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        EXPECT_EQ(points[i], sorted[i]);
+        EXPECT_EQ(ids[i], static_cast<int>(perm[i]));
+        EXPECT_EQ(names[i], std::to_string(perm[i]));
+    }
+}
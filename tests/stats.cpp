@@ -0,0 +1,139 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#include <zorder_knn/stats.hpp>
+#include "sort_zorder.hpp"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <array>
+
+namespace
+{
+
+using Point = std::array<float, 3>;
+using StatsLess = zorder_knn::Less<Point, 3, zorder_knn::XorMsbTable,
+    zorder_knn::CountStats>;
+
+}
+
+TEST(Stats, Branches)
+{
+    auto& counters = zorder_knn::CountStats::Counters();
+    counters.Reset();
+
+    StatsLess less;
+
+    // axis 2 is compared first and differs in sign
+    EXPECT_TRUE(less({{ 1.0f, 1.0f, -1.0f }}, {{ 1.0f, 1.0f, 1.0f }}));
+    EXPECT_EQ(counters.ncompare, 1u);
+    EXPECT_EQ(counters.nsign_mismatch, 1u);
+    ASSERT_EQ(counters.axis_sign_mismatch.size(), 3u);
+    EXPECT_EQ(counters.axis_sign_mismatch[2], 1u);
+    EXPECT_EQ(counters.ncoord_equal + counters.ncoord_equal_exp +
+        counters.ncoord_diff_exp, 0u);
+
+    // equal and negated zero coordinates, axis 1 shares the exponent and
+    // axis 0 differs in exponent and wins
+    EXPECT_TRUE(less({{ 1.0f, 1.0f, 0.0f }}, {{ 4.0f, 1.5f, -0.0f }}));
+    EXPECT_EQ(counters.ncompare, 2u);
+    EXPECT_EQ(counters.ncoord_equal, 1u);
+    EXPECT_EQ(counters.ncoord_equal_exp, 1u);
+    EXPECT_EQ(counters.ncoord_diff_exp, 1u);
+    ASSERT_EQ(counters.axis_wins.size(), 1u);
+    EXPECT_EQ(counters.axis_wins[0], 1u);
+
+    EXPECT_FALSE(less({{ 1.0f, 2.0f, 3.0f }}, {{ 1.0f, 2.0f, 3.0f }}));
+    EXPECT_EQ(counters.nequal, 1u);
+    EXPECT_EQ(counters.ncoord_equal, 4u);
+
+    std::ostringstream os;
+    counters.Dump(os);
+    EXPECT_NE(os.str().find("comparisons:        3"), std::string::npos);
+    EXPECT_NE(os.str().find("axis 2: sign mismatch 1, wins 0"), std::string::npos);
+
+    counters.Reset();
+    EXPECT_EQ(counters.ncompare, 0u);
+    EXPECT_TRUE(counters.axis_wins.empty());
+}
+
+TEST(Stats, Integers)
+{
+    using IntPoint = std::array<int32_t, 3>;
+    using IntStatsLess = zorder_knn::Less<IntPoint, 3, zorder_knn::XorMsbTable,
+        zorder_knn::CountStats>;
+
+    auto& counters = zorder_knn::CountStats::Counters();
+    counters.Reset();
+
+    IntStatsLess less;
+
+    // equal axis 2, axis 1 shares the highest bit and axis 0 has a higher
+    // one and wins
+    EXPECT_TRUE(less({{ 1, 4, -7 }}, {{ 9, 5, -7 }}));
+    EXPECT_EQ(counters.ncoord_equal, 1u);
+    EXPECT_EQ(counters.ncoord_equal_exp, 1u);
+    EXPECT_EQ(counters.ncoord_diff_exp, 1u);
+    ASSERT_EQ(counters.axis_wins.size(), 1u);
+    EXPECT_EQ(counters.axis_wins[0], 1u);
+
+    // the negation of the smallest integer is not taken
+    auto const min = std::numeric_limits<int32_t>::min();
+    EXPECT_FALSE(less({{ 0, 0, min }}, {{ 0, 0, min }}));
+    EXPECT_EQ(counters.nequal, 1u);
+    EXPECT_EQ(counters.ncoord_equal, 4u);
+
+    std::vector<IntPoint> points;
+    for (int32_t i{-20}; i <= 20; ++i)
+    {
+        points.push_back({{ i * 7 % 13, -i, i * i }});
+    }
+
+    auto points_stats = points;
+    std::sort(points.begin(), points.end(), zorder_knn::Less<IntPoint, 3>());
+    std::sort(points_stats.begin(), points_stats.end(), IntStatsLess());
+    EXPECT_EQ(points_stats, points);
+}
+
+TEST(Stats, Sort)
+{
+    std::vector<Point> points(10000);
+    test::GenerateRandomPoints(points);
+    auto points_stats = points;
+
+    auto& counters = zorder_knn::CountStats::Counters();
+    counters.Reset();
+
+    std::sort(points.begin(), points.end(), zorder_knn::Less<Point, 3>());
+    std::sort(points_stats.begin(), points_stats.end(), StatsLess());
+    EXPECT_EQ(points_stats, points);
+
+    // every comparison is decided exactly once
+    uint64_t ndecided = counters.nsign_mismatch + counters.nequal;
+    for (auto n : counters.axis_wins) { ndecided += n; }
+    EXPECT_GT(counters.ncompare, points.size());
+    EXPECT_EQ(ndecided, counters.ncompare);
+}
@@ -23,6 +23,9 @@
 #include <zorder_knn/less.hpp>
 
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <random>
 #include <vector>
 
 namespace
@@ -36,13 +39,32 @@ TestXorMsb(std::vector<Test> const& tests, bool only_double = false)
     for (auto const& t : tests)
     {
         EXPECT_EQ(zorder_knn::detail::FloatXorMsb(t.p, t.q), t.xor_msb);
+        EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(t.p, t.q), t.xor_msb);
 
         if (!only_double)
         {
-            EXPECT_EQ(zorder_knn::detail::FloatXorMsb(
-                static_cast<float>(t.p), static_cast<float>(t.q)),
-                t.xor_msb);
+            auto p = static_cast<float>(t.p);
+            auto q = static_cast<float>(t.q);
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsb(p, q), t.xor_msb);
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(p, q), t.xor_msb);
         }
+
+        // reduced precision wherever the values are exact
+        zorder_knn::BFloat16 pb(static_cast<float>(t.p)), qb(static_cast<float>(t.q));
+        if (double(pb) == t.p && double(qb) == t.q)
+        {
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsb(pb, qb), t.xor_msb);
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(pb, qb), t.xor_msb);
+        }
+
+#if defined(ZORDER_KNN_FLOAT16)
+        auto ph = static_cast<_Float16>(t.p), qh = static_cast<_Float16>(t.q);
+        if (double(ph) == t.p && double(qh) == t.q)
+        {
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsb(ph, qh), t.xor_msb);
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(ph, qh), t.xor_msb);
+        }
+#endif
     }
 }
 
@@ -105,4 +127,88 @@ TEST(FloatXorMsb, DifferingSignificand)
         { 1.0, 1.0 + 2.2204460e-16, -52 },
         { 1.0, 1.0 + 4.4408921e-16, -51 }
     }, true);
-}
\ No newline at end of file
+}
+
+TEST(FloatXorMsb, Zero)
+{
+    TestXorMsb({
+        {  0.0,     0.5,              -1 },
+        {  0.0,     1.5,               0 },
+        {  0.0,     0.001,           -10 },
+        { -0.0,     4.0,               2 }
+    });
+}
+
+TEST(FloatXorMsb, Subnormal)
+{
+    constexpr auto minf = std::numeric_limits<float>::min();
+    constexpr auto dminf = std::numeric_limits<float>::denorm_min();
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(minf, dminf), -126);
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(0.0f, dminf), -149);
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(dminf, 2.0f * dminf), -148);
+
+    constexpr auto mind = std::numeric_limits<double>::min();
+    constexpr auto dmind = std::numeric_limits<double>::denorm_min();
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(mind, dmind), -1022);
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(0.0, dmind), -1074);
+}
+
+TEST(FloatXorMsb, ClzMatchesTable)
+{
+    using limits = std::numeric_limits<float>;
+    std::vector<float> values = {
+        0.0f, -0.0f, limits::denorm_min(), 3.0f * limits::denorm_min(),
+        limits::min(), limits::min() - limits::denorm_min(), 0.1f, 1.0f,
+        1.5f, -1.75f, 2.0f, 1000.0f, limits::max(), limits::infinity()
+    };
+
+    for (auto p : values)
+    {
+        for (auto q : values)
+        {
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(p, q),
+                zorder_knn::detail::FloatXorMsb(p, q));
+            EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(double(p), double(-q)),
+                zorder_knn::detail::FloatXorMsb(double(p), double(-q)));
+        }
+    }
+}
+
+#if defined(ZORDER_KNN_FLOAT16)
+TEST(FloatXorMsb, SubnormalHalf)
+{
+    auto minh = static_cast<_Float16>(std::pow(2.0f, -14));
+    auto dminh = static_cast<_Float16>(std::pow(2.0f, -24));
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(minh, dminh), -14);
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsb(static_cast<_Float16>(0.0f), dminh), -24);
+    EXPECT_EQ(zorder_knn::detail::FloatXorMsbClz(static_cast<_Float16>(0.0f), dminh), -24);
+}
+#endif
+
+TEST(FloatXorMsb, Integer)
+{
+    using zorder_knn::detail::FloatXorMsb;
+    using zorder_knn::detail::FloatXorMsbClz;
+    constexpr auto min = std::numeric_limits<int>::min();
+
+    EXPECT_EQ(FloatXorMsb(0, 1), 0);
+    EXPECT_EQ(FloatXorMsb(1, 2), 1);
+    EXPECT_EQ(FloatXorMsb(3, 2), 0);
+    EXPECT_EQ(FloatXorMsb(-4, -6), 1);
+    EXPECT_EQ(FloatXorMsb(-5, 5), min);
+    EXPECT_EQ(FloatXorMsb(7, 7), min);
+    EXPECT_EQ(FloatXorMsb(uint8_t(255), uint8_t(0)), 7);
+    EXPECT_EQ(FloatXorMsb(int16_t(-32768), int16_t(0)), 15);
+    EXPECT_EQ(FloatXorMsb(std::numeric_limits<int64_t>::min(), int64_t(0)), 63);
+    EXPECT_EQ(FloatXorMsbClz(std::numeric_limits<uint64_t>::max(), uint64_t(1)), 63);
+
+    // integers behave as the floating point numbers of the same values
+    std::mt19937 e2(42);
+    std::uniform_int_distribution<int32_t> dist(-(1 << 24), 1 << 24);
+    for (int i{0}; i < 10000; ++i)
+    {
+        auto p = dist(e2) >> (i % 20), q = dist(e2) >> (i % 13);
+        EXPECT_EQ(FloatXorMsb(p, q), FloatXorMsb(double(p), double(q)));
+        EXPECT_EQ(FloatXorMsbClz(p, q), FloatXorMsb(double(p), double(q)));
+    }
+}
@@ -0,0 +1,152 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_BATCH_KNN_HPP
+#define ZORDER_KNN_BATCH_KNN_HPP
+
+#include "knn.hpp"
+#include "parallel_sort.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Index of the first point within the z-sorted range [first, n) not less
+// than p, found by galloping from first. Cheap if p is close to
+// points[first] in z-order.
+template <typename Point, std::size_t d>
+std::size_t
+GallopLowerBound(std::vector<Point> const& points, std::size_t first,
+    Point const& p)
+{
+    Less<Point, d> less;
+
+    auto n = points.size();
+    std::size_t step{1};
+    auto last = first;
+    while (last < n && less(points[last], p))
+    {
+        first = last + 1;
+        last += step;
+        step *= 2;
+    }
+
+    auto begin = points.begin();
+    return static_cast<std::size_t>(std::lower_bound(begin + first,
+        begin + std::min(last, n), p, less) - begin);
+}
+
+// Find the k nearest neighbors of the queries queries[order(i)] for i in
+// [begin, end), which are sorted in z-order, within sorted_points and
+// store them in the rows order(i) of neighbors. The z-position of a query
+// is found by galloping from the one of its predecessor.
+template <typename Point, std::size_t d, typename Order>
+void
+KnnSweep(std::vector<Point> const& sorted_points,
+    std::vector<Point> const& queries, Order order, std::size_t begin,
+    std::size_t end, std::size_t k, bool exact, std::size_t* neighbors)
+{
+    auto n = sorted_points.size();
+    KnnHeap<PointScalar<Point>> heap(k);
+
+    auto id = [](std::size_t j) { return j; };
+    auto window = std::min(2 * k, n);
+    auto npos = std::numeric_limits<std::size_t>::max();
+
+    std::size_t pos{0};
+    for (auto i = begin; i < end; ++i)
+    {
+        auto const& query = queries[order(i)];
+        pos = GallopLowerBound<Point, d>(sorted_points, pos, query);
+
+        auto lo = KnnWindowBegin(n, pos, k, window);
+        KnnWindow<Point, d>(sorted_points, query, npos, lo, lo + window, id,
+            heap);
+        if (exact)
+        {
+            KnnRefine<Point, d>(sorted_points, query, pos, lo, lo + window,
+                id, heap);
+        }
+
+        auto const& knn = heap.Sorted();
+        auto* row = neighbors + order(i) * k;
+        for (std::size_t m{0}; m < k; ++m) { row[m] = knn[m].second; }
+        heap.Clear();
+    }
+}
+
+} // namespace detail
+
+// Find the k nearest neighbors of each query within the points sorted in
+// z-order by Less, using the threads of the pool. The queries are sorted
+// in z-order as well and split into consecutive chunks, each of which is
+// swept alongside the points: the z-position of a query is found by
+// galloping from the one of its predecessor, and the candidate windows of
+// consecutive queries largely overlap. The neighbors are those of
+// FindKNearest().
+//
+// Returns queries.size() * min(k, n) indices into sorted_points, where
+// the neighbors of queries[i] in order of increasing distance occupy the
+// range [i * k, (i + 1) * k).
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+FindKNearestBatch(ThreadPool& pool, std::vector<Point> const& sorted_points,
+    std::vector<Point> const& queries, std::size_t k, bool exact = true)
+{
+    auto n = sorted_points.size();
+    k = std::min(k, n);
+    if (k == 0 || queries.empty()) return {};
+
+    auto perm = detail::ParallelSortPermutation<Point, d>(pool,
+        queries.begin(), queries.end());
+
+    std::vector<std::size_t> neighbors(queries.size() * k);
+    ParallelFor(pool, perm.size(), [&](std::size_t begin, std::size_t end) {
+        detail::KnnSweep<Point, d>(sorted_points, queries,
+            [&perm](std::size_t i) { return perm[i]; }, begin, end, k, exact,
+            neighbors.data());
+    });
+
+    return neighbors;
+}
+
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+FindKNearestBatch(std::vector<Point> const& sorted_points,
+    std::vector<Point> const& queries, std::size_t k, bool exact = true,
+    std::size_t nthreads = DefaultNumThreads())
+{
+    ThreadPool pool(nthreads);
+    return FindKNearestBatch<Point, d>(pool, sorted_points, queries, k, exact);
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_BATCH_KNN_HPP
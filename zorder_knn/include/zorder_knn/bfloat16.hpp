@@ -0,0 +1,83 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_BFLOAT16_HPP
+#define ZORDER_KNN_BFLOAT16_HPP
+
+#include <cstdint>
+#include <cstring>
+
+// Half precision coordinates are supported as _Float16 where the compiler
+// provides it, e.g. GCC 12 and Clang 15 on x86-64.
+#if defined(__FLT16_MANT_DIG__) && !defined(ZORDER_KNN_NO_FLOAT16)
+#define ZORDER_KNN_FLOAT16
+#endif
+
+namespace zorder_knn
+{
+
+// Brain floating point number, the upper 16 bits of a float, i.e. 8
+// exponent and 7 significand bits. Converting to float is exact and
+// arithmetic takes place in float.
+struct BFloat16
+{
+    uint16_t bits;
+
+    BFloat16() = default;
+
+    // Round to nearest, ties to even, nan stays nan.
+    explicit BFloat16(float x)
+    {
+        uint32_t xi{0};
+        std::memcpy(&xi, &x, sizeof(xi));
+
+        if ((xi & 0x7fffffffu) > 0x7f800000u)
+        {
+            bits = static_cast<uint16_t>((xi >> 16) | 0x0040u);
+        }
+        else
+        {
+            auto rounding = 0x7fffu + ((xi >> 16) & 1u);
+            bits = static_cast<uint16_t>((xi + rounding) >> 16);
+        }
+    }
+
+    static BFloat16 FromBits(uint16_t bits)
+    {
+        BFloat16 x;
+        x.bits = bits;
+        return x;
+    }
+
+    operator float() const
+    {
+        auto xi = static_cast<uint32_t>(bits) << 16;
+        float x{0.0f};
+        std::memcpy(&x, &xi, sizeof(x));
+
+        return x;
+    }
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_BFLOAT16_HPP
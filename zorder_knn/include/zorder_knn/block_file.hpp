@@ -0,0 +1,300 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_BLOCK_FILE_HPP
+#define ZORDER_KNN_BLOCK_FILE_HPP
+
+#include "less.hpp"
+#include "box.hpp"
+#include "file.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+// A block file stores z-sorted points in blocks of block_size points,
+// only the last block may hold fewer. The file starts with a
+// BlockFileHeader, followed by one BlockInfo per block and, at
+// data_offset, the points. All values are stored in the byte order of
+// the machine that wrote the file.
+struct BlockFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint32_t scalar_size;
+    uint32_t point_size;
+    uint64_t npoints;
+    uint64_t block_size;
+    uint64_t nblocks;
+    uint64_t index_offset;
+    uint64_t data_offset;
+};
+
+static_assert(sizeof(BlockFileHeader) == 64, "sizeof(BlockFileHeader) != 64");
+
+// Bounding box and the first and last point in z-order of a block. All
+// points p of the block satisfy !Less(p, first) and !Less(last, p).
+template <typename Point>
+struct BlockInfo
+{
+    Box<Point> box;
+    Point first, last;
+};
+
+namespace detail
+{
+
+constexpr char BlockFileMagic[8] = { 'Z', 'K', 'N', 'N', 'B', 'L', 'K', '\0' };
+constexpr uint32_t BlockFileVersion = 1;
+constexpr std::size_t BlockFileAlignment = 64;
+
+inline uint64_t
+AlignUp(uint64_t offset, uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+template <typename Point, std::size_t d>
+BlockFileHeader
+MakeBlockFileHeader(std::size_t npoints, std::size_t block_size)
+{
+    BlockFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BlockFileMagic, sizeof(header.magic));
+
+    header.version = BlockFileVersion;
+    header.dim = static_cast<uint32_t>(d);
+    header.scalar_size = static_cast<uint32_t>(sizeof(PointScalar<Point>));
+    header.point_size = static_cast<uint32_t>(sizeof(Point));
+    header.npoints = npoints;
+    header.block_size = block_size;
+    header.nblocks = npoints / block_size + (npoints % block_size != 0);
+    header.index_offset = sizeof(BlockFileHeader);
+    header.data_offset = AlignUp(header.index_offset +
+        header.nblocks * sizeof(BlockInfo<Point>), BlockFileAlignment);
+
+    return header;
+}
+
+template <typename Point, std::size_t d, typename ForwardIt>
+BlockInfo<Point>
+MakeBlockInfo(ForwardIt first, ForwardIt last)
+{
+    BlockInfo<Point> info{ { *first, *first }, *first, *first };
+    for (auto it = first; it != last; ++it)
+    {
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            info.box.lo[j] = std::min(info.box.lo[j], (*it)[j]);
+            info.box.hi[j] = std::max(info.box.hi[j], (*it)[j]);
+        }
+
+        info.last = *it;
+    }
+
+    return info;
+}
+
+} // namespace detail
+
+// Write the z-sorted points [first, last) to a block file at path, throws
+// std::runtime_error on failure.
+template <typename Point, std::size_t d, typename ForwardIt>
+void
+WriteBlockFile(std::string const& path, ForwardIt first, ForwardIt last,
+    std::size_t block_size = 4096)
+{
+    static_assert(std::is_trivially_copyable<Point>::value,
+        "Point must be trivially copyable");
+
+    if (block_size == 0) throw std::invalid_argument("block_size == 0");
+
+    auto npoints = static_cast<std::size_t>(std::distance(first, last));
+    auto header = detail::MakeBlockFileHeader<Point, d>(npoints, block_size);
+
+    std::vector<BlockInfo<Point>> index;
+    index.reserve(header.nblocks);
+    for (auto it = first; it != last;)
+    {
+        auto block_last = it;
+        std::advance(block_last, std::min(block_size,
+            static_cast<std::size_t>(std::distance(it, last))));
+
+        index.push_back(detail::MakeBlockInfo<Point, d>(it, block_last));
+        it = block_last;
+    }
+
+    detail::File file(path, "wb");
+    file.Write(&header, sizeof(header), 1);
+    file.Write(index.data(), sizeof(BlockInfo<Point>), index.size());
+
+    std::vector<unsigned char> padding(header.data_offset - header.index_offset -
+        index.size() * sizeof(BlockInfo<Point>), 0);
+    file.Write(padding.data(), 1, padding.size());
+
+    std::vector<Point> buffer;
+    buffer.reserve(std::min(block_size, npoints));
+    for (auto it = first; it != last; ++it)
+    {
+        buffer.push_back(*it);
+        if (buffer.size() == buffer.capacity())
+        {
+            file.Write(buffer.data(), sizeof(Point), buffer.size());
+            buffer.clear();
+        }
+    }
+
+    file.Write(buffer.data(), sizeof(Point), buffer.size());
+    file.Close();
+}
+
+#if defined(ZORDER_KNN_HAS_MMAP)
+
+// Memory-mapped block file. Opening reads only the header, the index and
+// the points of a block are paged in as they are accessed.
+template <typename Point, std::size_t d>
+class BlockFileReader
+{
+public:
+    explicit BlockFileReader(std::string const& path)
+        : file_(path)
+    {
+        static_assert(std::is_trivially_copyable<Point>::value,
+            "Point must be trivially copyable");
+
+        if (file_.Size() < sizeof(BlockFileHeader))
+            throw std::runtime_error("invalid block file " + path);
+
+        std::memcpy(&header_, file_.Data(), sizeof(header_));
+
+        // bound npoints by the file size first, so that the offsets of
+        // the expected header cannot overflow
+        if (header_.block_size == 0 || header_.data_offset > file_.Size() ||
+            header_.npoints > (file_.Size() - header_.data_offset) / sizeof(Point))
+        {
+            throw std::runtime_error("invalid block file " + path);
+        }
+
+        auto expected = detail::MakeBlockFileHeader<Point, d>(
+            static_cast<std::size_t>(header_.npoints),
+            static_cast<std::size_t>(header_.block_size));
+
+        // the header of a valid file is determined by npoints and
+        // block_size
+        if (std::memcmp(&header_, &expected, sizeof(header_)) != 0)
+            throw std::runtime_error("invalid block file " + path);
+
+        index_ = reinterpret_cast<BlockInfo<Point> const*>(
+            file_.Data() + header_.index_offset);
+        points_ = reinterpret_cast<Point const*>(
+            file_.Data() + header_.data_offset);
+    }
+
+    std::size_t Size() const { return static_cast<std::size_t>(header_.npoints); }
+
+    std::size_t BlockSize() const
+    {
+        return static_cast<std::size_t>(header_.block_size);
+    }
+
+    std::size_t NumBlocks() const
+    {
+        return static_cast<std::size_t>(header_.nblocks);
+    }
+
+    BlockInfo<Point> const& Block(std::size_t i) const { return index_[i]; }
+
+    // Points [BlockBegin(i), BlockEnd(i)) of block i.
+    Point const* BlockBegin(std::size_t i) const
+    {
+        return points_ + i * BlockSize();
+    }
+
+    Point const* BlockEnd(std::size_t i) const
+    {
+        return points_ + std::min((i + 1) * BlockSize(), Size());
+    }
+
+    // All points, in z-order.
+    Point const* Data() const { return points_; }
+
+    // Indices of the blocks whose bounding box intersects box. Only the
+    // blocks whose z-range [first, last] overlaps the z-range of the box
+    // [box.lo, box.hi] are tested.
+    std::vector<std::size_t> FindBlocks(Box<Point> const& box) const
+    {
+        Less<Point, d> less;
+
+        auto* begin = index_;
+        auto* end = index_ + NumBlocks();
+
+        auto* lo = std::partition_point(begin, end,
+            [&](BlockInfo<Point> const& b) { return less(b.last, box.lo); });
+        auto* hi = std::partition_point(lo, end,
+            [&](BlockInfo<Point> const& b) { return !less(box.hi, b.first); });
+
+        std::vector<std::size_t> blocks;
+        for (auto* b = lo; b != hi; ++b)
+        {
+            if (detail::Intersects<Point, d>(b->box, box))
+                blocks.push_back(static_cast<std::size_t>(b - begin));
+        }
+
+        return blocks;
+    }
+
+    // Call f(i, p) for all points p = Data()[i] within box.
+    template <typename F>
+    void ForEachInBox(Box<Point> const& box, F f) const
+    {
+        for (auto b : FindBlocks(box))
+        {
+            for (auto* p = BlockBegin(b); p != BlockEnd(b); ++p)
+            {
+                if (detail::Contains<Point, d>(box, *p))
+                    f(static_cast<std::size_t>(p - points_), *p);
+            }
+        }
+    }
+
+private:
+    detail::MappedFile file_;
+    BlockFileHeader header_;
+    BlockInfo<Point> const* index_;
+    Point const* points_;
+};
+
+#endif // ZORDER_KNN_HAS_MMAP
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_BLOCK_FILE_HPP
@@ -0,0 +1,282 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_BOX_HPP
+#define ZORDER_KNN_BOX_HPP
+
+#include "less.hpp"
+#include "key.hpp"
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+
+namespace zorder_knn
+{
+
+// Axis-aligned box [lo, hi], lo[j] <= hi[j] for all j.
+template <typename Point>
+struct Box
+{
+    Point lo, hi;
+};
+
+namespace detail
+{
+
+template <typename Scalar, typename UInt>
+Scalar
+UIntToFloat(UInt xi)
+{
+    static_assert(sizeof(Scalar) == sizeof(UInt), "sizeof(Scalar) != sizeof(UInt)");
+    using uchar = unsigned char; // sizeof(unsigned char) is one byte
+
+    Scalar x;
+    auto const* i = reinterpret_cast<uchar const*>(&xi);
+    std::copy(i, i + sizeof(UInt), reinterpret_cast<uchar*>(&x));
+
+    return x;
+}
+
+// Clear the magnitude bits of x below bit position y, the sign of x is
+// dropped.
+template <typename Scalar>
+Scalar
+FloatClearBelow(Scalar x, int y)
+{
+    auto fp = FloatToFixedPoint(x);
+    if (fp.sig == 0 || FixedPointMsb(fp) < y) return Scalar(0.0);
+
+    auto xi = FloatToUInt(std::abs(x));
+    auto nclear = std::min(std::max(y - fp.exp, 0),
+        static_cast<int>(significand<Scalar>::nbits));
+
+    using UInt = decltype(xi);
+    xi &= ~((UInt(1) << nclear) - 1);
+
+    return UIntToFloat<Scalar>(xi);
+}
+
+// 2^y, zero if y is below the smallest subnormal exponent and infinity if
+// y exceeds the largest exponent.
+template <typename Scalar>
+Scalar
+FloatPow2(int y)
+{
+    using UInt = decltype(FloatToUInt(Scalar(0.0)));
+    constexpr int nbits = significand<Scalar>::nbits;
+    constexpr int exp_min = std::numeric_limits<Scalar>::min_exponent - 1;
+    constexpr int exp_max = std::numeric_limits<Scalar>::max_exponent - 1;
+
+    if (y > exp_max) return std::numeric_limits<Scalar>::infinity();
+    if (y < exp_min - nbits) return Scalar(0.0);
+
+    auto xi = (y >= exp_min) ? UInt(y - exp_min + 1) << nbits
+                             : UInt(1) << (y - exp_min + nbits);
+    return UIntToFloat<Scalar>(xi);
+}
+
+// Split the box at the most significant bit of the z-order in which its
+// corners differ. All points of the lower box precede all points of the
+// upper box in z-order. Returns false if the corners are equal.
+template <typename Point, std::size_t d>
+bool
+SplitBox(Box<Point> const& box, Box<Point>& lower, Box<Point>& upper)
+{
+    using Scalar = PointScalar<Point>;
+    constexpr auto zero = Scalar(0.0);
+
+    lower = upper = box;
+
+    auto x = std::numeric_limits<int>::min();
+    std::size_t k{0};
+
+    for (std::size_t j{d}; j-- > 0;)
+    {
+        // split at zero, which belongs to the non-negative numbers
+        if ((box.lo[j] < zero) != (box.hi[j] < zero))
+        {
+            lower.hi[j] = -std::numeric_limits<Scalar>::denorm_min();
+            upper.lo[j] = zero;
+            return true;
+        }
+
+        auto y = FloatXorMsb(box.lo[j], box.hi[j]);
+        if (x < y)
+        {
+            x = y;
+            k = j;
+        }
+    }
+
+    if (x == std::numeric_limits<int>::min()) return false;
+
+    if (box.hi[k] > zero)
+    {
+        // |lo| and |hi| share the bits above x, hi has bit x set
+        auto m = FloatClearBelow(box.hi[k], x);
+        lower.hi[k] = std::nextafter(m, zero);
+        upper.lo[k] = m;
+    }
+    else
+    {
+        auto m = FloatClearBelow(box.lo[k], x);
+        lower.hi[k] = -m;
+        upper.lo[k] = -std::nextafter(m, zero);
+    }
+
+    return true;
+}
+
+// Smallest cell of the z-order containing p and q, i.e. the box of all
+// points sharing the bits of p and q preceding their first differing bit
+// in z-order. All points between p and q in z-order lie within the cell.
+template <typename Point, std::size_t d>
+Box<Point>
+CommonCell(Point const& p, Point const& q)
+{
+    using Scalar = PointScalar<Point>;
+    constexpr auto zero = Scalar(0.0);
+    constexpr auto inf = std::numeric_limits<Scalar>::infinity();
+
+    Box<Point> cell{p, p};
+
+    auto x = std::numeric_limits<int>::min();
+    std::size_t k{0};
+
+    for (std::size_t j{d}; j-- > 0;)
+    {
+        // only the signs of the preceding coordinates are shared
+        if ((p[j] < zero) != (q[j] < zero))
+        {
+            for (std::size_t i{0}; i < d; ++i)
+            {
+                auto negative = i > j && p[i] < zero;
+                auto positive = i > j && !(p[i] < zero);
+                cell.lo[i] = positive ? zero : -inf;
+                cell.hi[i] = negative ? -zero : inf;
+            }
+
+            return cell;
+        }
+
+        auto y = FloatXorMsb(p[j], q[j]);
+        if (x < y)
+        {
+            x = y;
+            k = j;
+        }
+    }
+
+    if (x == std::numeric_limits<int>::min()) return cell;
+
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        // bit x of coordinates preceding k in z-order is shared as well
+        auto y = (j > k) ? x : x + 1;
+
+        auto lo = FloatClearBelow(p[j], y);
+        auto hi = lo + FloatPow2<Scalar>(y);
+
+        cell.lo[j] = (p[j] < zero) ? -hi : lo;
+        cell.hi[j] = (p[j] < zero) ? -lo : hi;
+    }
+
+    return cell;
+}
+
+template <typename Point, std::size_t d>
+auto
+SquaredDistance(Point const& p, Point const& q) -> PointScalar<Point>
+{
+    PointScalar<Point> dist2{0};
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        auto x = p[j] - q[j];
+        dist2 += x * x;
+    }
+
+    return dist2;
+}
+
+template <typename Point, std::size_t d>
+auto
+SquaredDistance(Point const& p, Box<Point> const& box) -> PointScalar<Point>
+{
+    PointScalar<Point> dist2{0};
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        auto x = std::max(std::max(box.lo[j] - p[j], p[j] - box.hi[j]),
+            PointScalar<Point>(0));
+        dist2 += x * x;
+    }
+
+    return dist2;
+}
+
+// Squared distance between the closest points of the boxes.
+template <typename Point, std::size_t d>
+auto
+SquaredDistance(Box<Point> const& a, Box<Point> const& b) -> PointScalar<Point>
+{
+    PointScalar<Point> dist2{0};
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        auto x = std::max(std::max(a.lo[j] - b.hi[j], b.lo[j] - a.hi[j]),
+            PointScalar<Point>(0));
+        dist2 += x * x;
+    }
+
+    return dist2;
+}
+
+template <typename Point, std::size_t d>
+bool
+Contains(Box<Point> const& box, Point const& p)
+{
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        if (p[j] < box.lo[j] || box.hi[j] < p[j]) return false;
+    }
+
+    return true;
+}
+
+template <typename Point, std::size_t d>
+bool
+Intersects(Box<Point> const& a, Box<Point> const& b)
+{
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        if (b.hi[j] < a.lo[j] || a.hi[j] < b.lo[j]) return false;
+    }
+
+    return true;
+}
+
+} // namespace detail
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_BOX_HPP
@@ -0,0 +1,312 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_CELL_LIST_HPP
+#define ZORDER_KNN_CELL_LIST_HPP
+
+#include "parallel_sort.hpp"
+#include "thread_pool.hpp"
+#include "box.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+constexpr std::size_t
+Pow3(std::size_t k)
+{
+    return k == 0 ? 1 : 3 * Pow3(k - 1);
+}
+
+} // namespace detail
+
+// Uniform grid of cells of edge length h for fixed-radius neighbor
+// searches with radius h. The cells are enlarged by a factor of
+// 1 + 2^-20 and computed in double precision, so rounding errors never
+// place two points within distance h of each other more than one cell
+// apart. The points are binned into the cells, the cells
+// are sorted in z-order by Less on their integer coordinates, and the
+// points of each cell are stored contiguously in that order. The offsets
+// of the cells live in a flat array, which an open-addressing hash table
+// indexes by cell coordinates. Neighbors of a point lie within the 3^d
+// cells around the one of the point, which the iteration below visits in
+// z-order, i.e. mostly in the order of memory.
+//
+// The cell list keeps a sorted copy of the points, indices refer to it
+// unless stated otherwise, see Points() and Index(). Throws
+// std::invalid_argument unless h > 0.
+template <typename Point, std::size_t d>
+class CellList
+{
+public:
+    using Scalar = detail::PointScalar<Point>;
+    using Cell = std::array<int64_t, d>;
+
+    CellList(ThreadPool& pool, std::vector<Point> const& points, Scalar h)
+        : h_{h}, cell_size_{CellSize(h)}, origin_()
+    {
+        Build(pool, points);
+    }
+
+    CellList(std::vector<Point> const& points, Scalar h,
+        std::size_t nthreads = DefaultNumThreads())
+        : h_{h}, cell_size_{CellSize(h)}, origin_()
+    {
+        ThreadPool pool(nthreads);
+        Build(pool, points);
+    }
+
+    Scalar Radius() const { return h_; }
+    std::size_t Size() const { return points_.size(); }
+    std::size_t NumCells() const { return cells_.size(); }
+
+    // Points sorted by cell, Points()[i] is the point Index(i) of the
+    // points the cell list was built of.
+    std::vector<Point> const& Points() const { return points_; }
+    std::size_t Index(std::size_t i) const { return ids_[i]; }
+
+    // Coordinates of the cell holding p.
+    Cell CellOf(Point const& p) const
+    {
+        Cell c;
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            c[j] = static_cast<int64_t>(std::floor((static_cast<double>(p[j])
+                - static_cast<double>(origin_[j])) / cell_size_));
+        }
+
+        return c;
+    }
+
+    // Range [CellBegin(c), CellEnd(c)) of the points of cell c, where c
+    // is an index into the cells in z-order.
+    std::size_t CellBegin(std::size_t c) const { return starts_[c]; }
+    std::size_t CellEnd(std::size_t c) const { return starts_[c + 1]; }
+
+    // Index of the cell with the given coordinates, NumCells() if the
+    // cell holds no points.
+    std::size_t FindCell(Cell const& cell) const
+    {
+        if (table_.empty()) return NumCells();
+
+        auto mask = table_.size() - 1;
+        for (auto slot = Hash(cell) & mask;; slot = (slot + 1) & mask)
+        {
+            auto c = table_[slot];
+            if (c == empty_slot) return NumCells();
+            if (cells_[c] == cell) return c;
+        }
+    }
+
+    // Call f(j) for all points within distance h of p.
+    template <typename F>
+    void ForEachNeighbor(Point const& p, F f) const
+    {
+        auto h2 = h_ * h_;
+        ForEachNeighborCell(CellOf(p), [&](std::size_t c) {
+            for (auto j = starts_[c]; j < starts_[c + 1]; ++j)
+            {
+                if (detail::SquaredDistance<Point, d>(p, points_[j]) <= h2) f(j);
+            }
+        });
+    }
+
+    // Indices of all points within distance h of p in increasing order.
+    std::vector<std::size_t> FindNeighbors(Point const& p) const
+    {
+        std::vector<std::size_t> found;
+        ForEachNeighbor(p, [&found](std::size_t j) { found.push_back(j); });
+        std::sort(found.begin(), found.end());
+
+        return found;
+    }
+
+    // Call f(i, j) for all ordered pairs of distinct points i and j within
+    // distance h of each other, in parallel over the cells of i. All calls
+    // for a point i come from the same thread, so f may accumulate into
+    // per-point state of i without synchronization.
+    template <typename F>
+    void ForEachPair(ThreadPool& pool, F f) const
+    {
+        auto h2 = h_ * h_;
+        ParallelFor(pool, NumCells(), [&](std::size_t begin, std::size_t end) {
+            for (auto c = begin; c < end; ++c)
+            {
+                ForEachNeighborCell(cells_[c], [&](std::size_t c_other) {
+                    for (auto i = starts_[c]; i < starts_[c + 1]; ++i)
+                    {
+                        for (auto j = starts_[c_other]; j < starts_[c_other + 1]; ++j)
+                        {
+                            if (i != j && detail::SquaredDistance<Point, d>(
+                                points_[i], points_[j]) <= h2) f(i, j);
+                        }
+                    }
+                });
+            }
+        });
+    }
+
+    template <typename F>
+    void ForEachPair(F f, std::size_t nthreads = DefaultNumThreads()) const
+    {
+        ThreadPool pool(nthreads);
+        ForEachPair(pool, f);
+    }
+
+private:
+    static constexpr std::size_t empty_slot =
+        std::numeric_limits<std::size_t>::max();
+
+    static double CellSize(Scalar h)
+    {
+        return static_cast<double>(h) * (1.0 + std::ldexp(1.0, -20));
+    }
+
+    static std::size_t Hash(Cell const& cell)
+    {
+        uint64_t hash{0};
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            hash = (hash ^ static_cast<uint64_t>(cell[j])) * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 29;
+        }
+
+        return static_cast<std::size_t>(hash);
+    }
+
+    // Call f(c) for the indices of the non-empty cells among the 3^d
+    // cells around the given one, in z-order.
+    template <typename F>
+    void ForEachNeighborCell(Cell const& cell, F f) const
+    {
+        std::array<std::size_t, detail::Pow3(d)> found;
+        std::size_t nfound{0};
+        for (auto const& offset : offsets_)
+        {
+            auto other = cell;
+            for (std::size_t j{0}; j < d; ++j) { other[j] += offset[j]; }
+
+            auto c = FindCell(other);
+            if (c != NumCells()) found[nfound++] = c;
+        }
+
+        std::sort(found.begin(), found.begin() + nfound);
+        for (std::size_t m{0}; m < nfound; ++m) { f(found[m]); }
+    }
+
+    void Build(ThreadPool& pool, std::vector<Point> const& points)
+    {
+        // also rejects nan
+        if (!(h_ > Scalar(0))) throw std::invalid_argument("h <= 0");
+
+        for (std::size_t m{0}; m < offsets_.size(); ++m)
+        {
+            auto k = m;
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                offsets_[m][j] = static_cast<int64_t>(k % 3) - 1;
+                k /= 3;
+            }
+        }
+
+        auto n = points.size();
+        if (n == 0) return;
+
+        origin_ = points.front();
+        for (auto const& p : points)
+        {
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                origin_[j] = std::min(origin_[j], p[j]);
+            }
+        }
+
+        // integer cell coordinates, exact in double, order the cells
+        using CellPoint = std::array<double, d>;
+        std::vector<Cell> cells(n);
+        std::vector<CellPoint> cell_points(n);
+        ParallelFor(pool, n, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i)
+            {
+                cells[i] = CellOf(points[i]);
+                for (std::size_t j{0}; j < d; ++j)
+                {
+                    cell_points[i][j] = static_cast<double>(cells[i][j]);
+                }
+            }
+        });
+
+        ids_ = detail::ParallelSortPermutation<CellPoint, d>(pool,
+            cell_points.begin(), cell_points.end());
+
+        points_.resize(n);
+        ParallelFor(pool, n, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) { points_[i] = points[ids_[i]]; }
+        });
+
+        for (std::size_t i{0}; i < n; ++i)
+        {
+            if (i == 0 || cells[ids_[i]] != cells[ids_[i - 1]])
+            {
+                cells_.push_back(cells[ids_[i]]);
+                starts_.push_back(i);
+            }
+        }
+        starts_.push_back(n);
+
+        std::size_t size{1};
+        while (size < 2 * cells_.size()) { size *= 2; }
+        table_.assign(size, empty_slot);
+        for (std::size_t c{0}; c < cells_.size(); ++c)
+        {
+            auto slot = Hash(cells_[c]) & (size - 1);
+            while (table_[slot] != empty_slot) { slot = (slot + 1) & (size - 1); }
+            table_[slot] = c;
+        }
+    }
+
+    Scalar h_;
+    double cell_size_;
+    Point origin_;
+    std::array<Cell, detail::Pow3(d)> offsets_;
+
+    std::vector<Point> points_;
+    std::vector<std::size_t> ids_;
+    std::vector<Cell> cells_;
+    std::vector<std::size_t> starts_;
+    std::vector<std::size_t> table_;
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_CELL_LIST_HPP
@@ -0,0 +1,433 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_COMPRESSED_POINTS_HPP
+#define ZORDER_KNN_COMPRESSED_POINTS_HPP
+
+#include "less.hpp"
+#include "key.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+template <std::size_t size> struct UIntOfSize;
+template <> struct UIntOfSize<1> { using type = uint8_t; };
+template <> struct UIntOfSize<2> { using type = uint16_t; };
+template <> struct UIntOfSize<4> { using type = uint32_t; };
+template <> struct UIntOfSize<8> { using type = uint64_t; };
+
+template <typename Scalar> struct IsSignMagnitude : std::is_floating_point<Scalar> {};
+template <> struct IsSignMagnitude<BFloat16> : std::true_type {};
+#if defined(ZORDER_KNN_FLOAT16)
+template <> struct IsSignMagnitude<_Float16> : std::true_type {};
+#endif
+
+// Maps the bit pattern of a coordinate to an unsigned integer of the same
+// order, i.e. x < y if and only if Encode(x) < Encode(y) for floating
+// point numbers other than nan. -0.0 precedes 0.0, the mapping is
+// lossless.
+template <typename Scalar>
+struct OrderedBits
+{
+    static_assert(std::is_trivially_copyable<Scalar>::value,
+        "Scalar must be trivially copyable");
+
+    using UInt = typename UIntOfSize<sizeof(Scalar)>::type;
+
+    static constexpr int nbits = 8 * sizeof(Scalar);
+    static constexpr uint64_t all = ~uint64_t(0) >> (64 - nbits);
+    static constexpr uint64_t sign = uint64_t(1) << (nbits - 1);
+
+    static uint64_t Encode(Scalar x)
+    {
+        UInt xi{0};
+        std::memcpy(&xi, &x, sizeof(Scalar));
+        uint64_t u = xi;
+
+        if (IsSignMagnitude<Scalar>::value)
+            return u ^ ((u & sign) ? all : sign);
+        else if (std::is_signed<Scalar>::value)
+            return u ^ sign;
+        else
+            return u;
+    }
+
+    static Scalar Decode(uint64_t o)
+    {
+        uint64_t u{o};
+        if (IsSignMagnitude<Scalar>::value)
+            u = o ^ ((o & sign) ? sign : all);
+        else if (std::is_signed<Scalar>::value)
+            u = o ^ sign;
+
+        return FromBits(u);
+    }
+
+    static Scalar FromBits(uint64_t u)
+    {
+        auto xi = static_cast<UInt>(u);
+        Scalar x;
+        std::memcpy(&x, &xi, sizeof(Scalar));
+
+        return x;
+    }
+
+    // The bit patterns of Decode(base + offset) for all offsets up to
+    // 2^w - 1 as c + offset or c - offset, given by m = 0 or m = ~0,
+    // i.e. c + ((offset ^ m) - m). Floating point numbers of both signs
+    // have no such form.
+    static bool Linear(uint64_t base, unsigned w, uint64_t* c, uint64_t* m)
+    {
+        *m = 0;
+        if (IsSignMagnitude<Scalar>::value)
+        {
+            auto hi = base + (w ? ~uint64_t(0) >> (64 - w) : 0);
+            if (hi < base || hi > all || ((base ^ hi) & sign)) return false;
+
+            if (base & sign)
+            {
+                *c = base ^ sign;
+            }
+            else
+            {
+                *c = all - base;
+                *m = ~uint64_t(0);
+            }
+        }
+        else if (std::is_signed<Scalar>::value)
+        {
+            *c = base + sign;
+        }
+        else
+        {
+            *c = base;
+        }
+
+        return true;
+    }
+};
+
+// Or the w lowest bits of v into the bit stream at bit position pos.
+inline void
+PutBits(uint64_t* words, uint64_t pos, uint64_t v, unsigned w)
+{
+    auto k = pos >> 6;
+    auto s = static_cast<unsigned>(pos & 63);
+
+    words[k] |= v << s;
+    if (s + w > 64) words[k + 1] |= v >> (64 - s);
+}
+
+// The bits at position pos selected by mask, reads words[pos / 64 + 1]
+// in any case to avoid a branch.
+inline uint64_t
+GetBits(uint64_t const* words, uint64_t pos, uint64_t mask)
+{
+    auto k = pos >> 6;
+    auto s = static_cast<unsigned>(pos & 63);
+
+    return ((words[k] >> s) | ((words[k + 1] << 1) << (63 - s))) & mask;
+}
+
+constexpr uint64_t
+BitMask(unsigned w)
+{
+    return w ? ~uint64_t(0) >> (64 - w) : 0;
+}
+
+// Offset k of w bits each, starting at words[0]. All shifts are known at
+// compile time.
+template <unsigned w, std::size_t k>
+inline uint64_t
+UnpackOffset(uint64_t const* words)
+{
+    constexpr std::size_t i = k * w / 64;
+    constexpr unsigned s = k * w % 64;
+
+    auto v = words[i] >> s;
+    if (s + w > 64) v |= (words[i + 1] << 1) << (63 - s);
+
+    return v & BitMask(w);
+}
+
+template <typename Point, unsigned w, std::size_t... k>
+inline void
+UnpackColumn64(uint64_t const* words, uint64_t c, uint64_t m, Point* out,
+    std::size_t j, std::index_sequence<k...>)
+{
+    using Scalar = PointScalar<Point>;
+
+    int expand[] = { (out[k][j] = OrderedBits<Scalar>::FromBits(
+        c + ((UnpackOffset<w, k>(words) ^ m) - m)), 0)... };
+    static_cast<void>(expand);
+}
+
+// Decode coordinate j of n points from offsets of w bits each, given
+// their linear form c, m, see OrderedBits::Linear(). Groups of 64
+// offsets span w words.
+template <typename Point, unsigned w>
+void
+UnpackColumn(uint64_t const* words, std::size_t n, uint64_t c, uint64_t m,
+    Point* out, std::size_t j)
+{
+    using Scalar = PointScalar<Point>;
+
+    std::size_t k{0};
+    for (; k + 64 <= n; k += 64, words += w)
+    {
+        UnpackColumn64<Point, w>(words, c, m, out + k, j,
+            std::make_index_sequence<64>());
+    }
+
+    for (std::size_t i{0}; k < n; ++k, ++i)
+    {
+        out[k][j] = OrderedBits<Scalar>::FromBits(
+            c + ((GetBits(words, i * w, BitMask(w)) ^ m) - m));
+    }
+}
+
+template <typename Point>
+using UnpackColumnFn = void (*)(uint64_t const*, std::size_t, uint64_t,
+    uint64_t, Point*, std::size_t);
+
+template <typename Point, std::size_t... w>
+inline UnpackColumnFn<Point>
+UnpackColumnKernel(unsigned width, std::index_sequence<w...>)
+{
+    static constexpr UnpackColumnFn<Point> kernels[] = {
+        &UnpackColumn<Point, static_cast<unsigned>(w)>... };
+
+    return kernels[width];
+}
+
+} // namespace detail
+
+// Points stored in blocks of block_size points, only the last block may
+// hold fewer. Each coordinate is mapped to an unsigned integer of the
+// same order, a block stores per coordinate the minimum of these
+// integers as base and the offsets of all points from it, bit-packed with
+// the width of the largest offset. The offsets of a coordinate are
+// stored contiguously from a word boundary on, so that a block decodes
+// one coordinate at a time with shifts known at compile time and without
+// branches.
+//
+// Any order of the points is stored losslessly, but points sorted by Less
+// share their high-order bits within a block and compress best.
+template <typename Point, std::size_t d>
+class CompressedPoints
+{
+public:
+    using Scalar = detail::PointScalar<Point>;
+
+    CompressedPoints() = default;
+
+    template <typename ForwardIt>
+    CompressedPoints(ForwardIt first, ForwardIt last,
+        std::size_t block_size = 256)
+        : size_(static_cast<std::size_t>(std::distance(first, last)))
+        , block_size_(block_size)
+    {
+        if (block_size == 0) throw std::invalid_argument("block_size == 0");
+
+        auto nblocks = (size_ + block_size - 1) / block_size;
+        bases_.resize(nblocks * d);
+        widths_.resize(nblocks * d);
+        offsets_.resize(nblocks + 1, 0);
+
+        std::vector<uint64_t> ordered;
+        ordered.reserve(std::min(block_size, size_) * d);
+
+        for (std::size_t b{0}; b < nblocks; ++b)
+        {
+            auto n = BlockEnd(b) - BlockBegin(b);
+
+            ordered.clear();
+            for (std::size_t i{0}; i < n; ++i, ++first)
+            {
+                Point const& p = *first;
+                for (std::size_t j{0}; j < d; ++j)
+                {
+                    ordered.push_back(detail::OrderedBits<Scalar>::Encode(p[j]));
+                }
+            }
+
+            uint64_t nwords{0};
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                auto lo = ordered[j], hi = ordered[j];
+                for (std::size_t i{1}; i < n; ++i)
+                {
+                    lo = std::min(lo, ordered[i * d + j]);
+                    hi = std::max(hi, ordered[i * d + j]);
+                }
+
+                bases_[b * d + j] = lo;
+                widths_[b * d + j] = static_cast<uint8_t>(
+                    (hi > lo) ? detail::UIntLogBase2(hi - lo) + 1 : 0);
+                nwords += ColumnWords(n, widths_[b * d + j]);
+            }
+
+            offsets_[b + 1] = offsets_[b] + nwords;
+
+            // one word of padding for GetBits
+            words_.resize(offsets_[b + 1] + 1, 0);
+
+            auto* column = words_.data() + offsets_[b];
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                unsigned w = widths_[b * d + j];
+                for (std::size_t i{0}; i < n; ++i)
+                {
+                    detail::PutBits(column, i * w,
+                        ordered[i * d + j] - bases_[b * d + j], w);
+                }
+
+                column += ColumnWords(n, w);
+            }
+        }
+
+        words_.shrink_to_fit();
+    }
+
+    std::size_t Size() const { return size_; }
+
+    std::size_t BlockSize() const { return block_size_; }
+
+    std::size_t NumBlocks() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+    // Points [BlockBegin(i), BlockEnd(i)) form block i.
+    std::size_t BlockBegin(std::size_t i) const { return i * block_size_; }
+
+    std::size_t BlockEnd(std::size_t i) const
+    {
+        return std::min((i + 1) * block_size_, size_);
+    }
+
+    // Decode the points of block i to out, which must have room for
+    // BlockEnd(i) - BlockBegin(i) points. Returns out past the last point.
+    Point* DecodeBlock(std::size_t i, Point* out) const
+    {
+        constexpr auto nkernels = detail::OrderedBits<Scalar>::nbits + 1;
+
+        auto n = BlockEnd(i) - BlockBegin(i);
+        auto const* column = words_.data() + offsets_[i];
+
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            unsigned w = widths_[i * d + j];
+            auto base = bases_[i * d + j];
+
+            uint64_t c, m;
+            if (detail::OrderedBits<Scalar>::Linear(base, w, &c, &m))
+            {
+                auto unpack = detail::UnpackColumnKernel<Point>(w,
+                    std::make_index_sequence<nkernels>());
+                unpack(column, n, c, m, out, j);
+            }
+            else
+            {
+                for (std::size_t k{0}; k < n; ++k)
+                {
+                    out[k][j] = detail::OrderedBits<Scalar>::Decode(base +
+                        detail::GetBits(column, k * w, detail::BitMask(w)));
+                }
+            }
+
+            column += ColumnWords(n, w);
+        }
+
+        return out + n;
+    }
+
+    // Decode all points to out.
+    Point* Decode(Point* out) const
+    {
+        for (std::size_t i{0}; i < NumBlocks(); ++i) { out = DecodeBlock(i, out); }
+        return out;
+    }
+
+    std::vector<Point> Decode() const
+    {
+        std::vector<Point> points(size_);
+        Decode(points.data());
+        return points;
+    }
+
+    // Point i, decoded without decoding the rest of its block.
+    Point operator[](std::size_t i) const
+    {
+        auto b = i / block_size_;
+        auto k = i % block_size_;
+        auto n = BlockEnd(b) - BlockBegin(b);
+        auto const* column = words_.data() + offsets_[b];
+
+        Point p;
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            unsigned w = widths_[b * d + j];
+            p[j] = detail::OrderedBits<Scalar>::Decode(bases_[b * d + j] +
+                detail::GetBits(column, k * w, detail::BitMask(w)));
+            column += ColumnWords(n, w);
+        }
+
+        return p;
+    }
+
+    // Bytes of memory held, bit stream and block headers.
+    std::size_t MemoryUsage() const
+    {
+        return words_.size() * sizeof(uint64_t) +
+            bases_.size() * sizeof(uint64_t) +
+            widths_.size() * sizeof(uint8_t) +
+            offsets_.size() * sizeof(uint64_t);
+    }
+
+private:
+    static std::size_t ColumnWords(std::size_t n, unsigned w)
+    {
+        return (n * w + 63) / 64;
+    }
+
+    std::size_t size_{0};
+    std::size_t block_size_{1};
+    std::vector<uint64_t> words_;
+    std::vector<uint64_t> bases_;
+    std::vector<uint8_t> widths_;
+    std::vector<uint64_t> offsets_;
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_COMPRESSED_POINTS_HPP
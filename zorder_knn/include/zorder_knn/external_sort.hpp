@@ -0,0 +1,386 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_EXTERNAL_SORT_HPP
+#define ZORDER_KNN_EXTERNAL_SORT_HPP
+
+#include "sort.hpp"
+#include "file.hpp"
+#include "merge.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+struct ExternalSortOptions
+{
+    // Points per run, bounds the memory used while forming runs.
+    std::size_t run_size = std::size_t(1) << 24;
+
+    // Number of runs merged at once.
+    std::size_t fan_in = 64;
+
+    // Points per read buffer of each run and of the write buffer while
+    // merging.
+    std::size_t buffer_size = std::size_t(1) << 16;
+
+    // Read the input file memory-mapped, where supported.
+    bool use_mmap = false;
+};
+
+struct ExternalSortStats
+{
+    std::size_t npoints = 0;
+    std::size_t nruns = 0;
+    std::size_t nmerge_passes = 0;
+
+    // Time spent in reading and writing files, and in everything else.
+    double io_seconds = 0.0;
+    double compute_seconds = 0.0;
+};
+
+namespace detail
+{
+
+// Adds the time elapsed during its lifetime to seconds.
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(double& seconds)
+        : seconds_(seconds), start_{std::chrono::steady_clock::now()} {}
+
+    ~ScopedTimer()
+    {
+        seconds_ += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    double& seconds_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Sequential reader of a raw binary file of points, throws
+// std::runtime_error if the file ends in a partial point.
+template <typename Point>
+class PointReader
+{
+public:
+    PointReader(std::string const& path, bool use_mmap, double& io_seconds)
+        : io_seconds_(io_seconds), path_{path}, offset_{0}
+    {
+        ScopedTimer timer(io_seconds_);
+
+#if defined(ZORDER_KNN_HAS_MMAP)
+        if (use_mmap)
+        {
+            mapped_.reset(new MappedFile(path));
+            if (mapped_->Size() % sizeof(Point) != 0) ThrowPartialPoint();
+            mapped_->AdviseSequential();
+            return;
+        }
+#else
+        (void)use_mmap;
+#endif
+
+        file_.reset(new File(path, "rb"));
+    }
+
+    // Read up to count points, returns the number of points read.
+    std::size_t Read(Point* points, std::size_t count)
+    {
+        ScopedTimer timer(io_seconds_);
+
+#if defined(ZORDER_KNN_HAS_MMAP)
+        if (mapped_)
+        {
+            auto n = std::min(count, (mapped_->Size() - offset_) / sizeof(Point));
+            std::memcpy(points, mapped_->Data() + offset_, n * sizeof(Point));
+            offset_ += n * sizeof(Point);
+            return n;
+        }
+#endif
+
+        auto n = file_->Read(points, 1, count * sizeof(Point));
+        if (n % sizeof(Point) != 0) ThrowPartialPoint();
+        return n / sizeof(Point);
+    }
+
+private:
+    void ThrowPartialPoint() const
+    {
+        throw std::runtime_error("size of " + path_ +
+            " is not a multiple of the point size");
+    }
+
+    double& io_seconds_;
+    std::string path_;
+    std::unique_ptr<File> file_;
+#if defined(ZORDER_KNN_HAS_MMAP)
+    std::unique_ptr<MappedFile> mapped_;
+#endif
+    std::size_t offset_;
+};
+
+// Buffered sequential writer of a raw binary file of points.
+template <typename Point>
+class PointWriter
+{
+public:
+    PointWriter(std::string const& path, std::size_t buffer_size,
+        double& io_seconds)
+        : io_seconds_(io_seconds), buffer_size_{buffer_size}
+    {
+        ScopedTimer timer(io_seconds_);
+        file_.reset(new File(path, "wb"));
+        buffer_.reserve(buffer_size_);
+    }
+
+    void Push(Point const& p)
+    {
+        buffer_.push_back(p);
+        if (buffer_.size() == buffer_size_) Flush();
+    }
+
+    void Write(Point const* points, std::size_t count)
+    {
+        Flush();
+        ScopedTimer timer(io_seconds_);
+        file_->Write(points, sizeof(Point), count);
+    }
+
+    void Close()
+    {
+        Flush();
+        ScopedTimer timer(io_seconds_);
+        file_->Close();
+    }
+
+private:
+    void Flush()
+    {
+        ScopedTimer timer(io_seconds_);
+        file_->Write(buffer_.data(), sizeof(Point), buffer_.size());
+        buffer_.clear();
+    }
+
+    double& io_seconds_;
+    std::unique_ptr<File> file_;
+    std::size_t buffer_size_;
+    std::vector<Point> buffer_;
+};
+
+// Buffered cursor on a sorted run.
+template <typename Point>
+class RunCursor
+{
+public:
+    RunCursor(std::string const& path, std::size_t buffer_size,
+        double& io_seconds)
+        : reader_(path, false, io_seconds), buffer_(buffer_size), pos_{0}, size_{0}
+    {
+        Fill();
+    }
+
+    bool Done() const { return pos_ == size_; }
+    Point const& Head() const { return buffer_[pos_]; }
+
+    void Next()
+    {
+        if (++pos_ == size_) Fill();
+    }
+
+private:
+    void Fill()
+    {
+        size_ = reader_.Read(buffer_.data(), buffer_.size());
+        pos_ = 0;
+    }
+
+    PointReader<Point> reader_;
+    std::vector<Point> buffer_;
+    std::size_t pos_, size_;
+};
+
+inline std::string
+RunPath(std::string const& output, std::size_t i)
+{
+    return output + ".run" + std::to_string(i);
+}
+
+// Removes the temporary runs of a sort when it ends, also if it ends by
+// an exception.
+class RunFiles
+{
+public:
+    RunFiles() = default;
+    RunFiles(RunFiles const&) = delete;
+    RunFiles& operator=(RunFiles const&) = delete;
+
+    ~RunFiles()
+    {
+        for (auto const& path : paths_) { std::remove(path.c_str()); }
+    }
+
+    std::string const& Add(std::string path)
+    {
+        paths_.push_back(std::move(path));
+        return paths_.back();
+    }
+
+private:
+    std::vector<std::string> paths_;
+};
+
+// Merge the sorted runs into output with a loser tree. Ties are broken by
+// the index of the run, which keeps the merge stable.
+template <typename Point, std::size_t d>
+void
+MergeRuns(std::vector<std::string> const& runs, std::string const& output,
+    ExternalSortOptions const& options, ExternalSortStats& stats)
+{
+    std::vector<std::unique_ptr<RunCursor<Point>>> cursors;
+    for (auto const& run : runs)
+    {
+        cursors.emplace_back(new RunCursor<Point>(run, options.buffer_size,
+            stats.io_seconds));
+    }
+
+    Less<Point, d> less;
+    auto tree = MakeLoserTree(cursors.size(),
+        [&](std::size_t a, std::size_t b) {
+            return less(cursors[a]->Head(), cursors[b]->Head());
+        },
+        [&](std::size_t i) { return cursors[i]->Done(); });
+
+    PointWriter<Point> writer(output, options.buffer_size, stats.io_seconds);
+    while (!tree.Empty())
+    {
+        auto& cursor = *cursors[tree.Top()];
+        writer.Push(cursor.Head());
+        cursor.Next();
+        tree.Replay(cursor.Done());
+    }
+    writer.Close();
+}
+
+} // namespace detail
+
+// Sort a raw binary file of points, which may be larger than the
+// available memory, in z-order. Runs of options.run_size points are
+// sorted in memory by Sort() and written to temporary files next to the
+// output, which are merged options.fan_in at a time until the output is
+// written. The result equals the one of Sort() on the whole file. Throws
+// std::runtime_error on I/O failure.
+template <typename Point, std::size_t d>
+ExternalSortStats
+ExternalSort(std::string const& input, std::string const& output,
+    ExternalSortOptions const& options = ExternalSortOptions())
+{
+    static_assert(std::is_trivially_copyable<Point>::value,
+        "points are read and written as raw bytes");
+
+    ExternalSortStats stats;
+    double total_seconds{0.0};
+    {
+        detail::ScopedTimer timer(total_seconds);
+
+        auto fan_in = std::max(options.fan_in, std::size_t(2));
+        std::size_t nruns{0};
+        detail::RunFiles run_files;
+
+        // form sorted runs
+        std::vector<std::string> runs;
+        {
+            detail::PointReader<Point> reader(input, options.use_mmap,
+                stats.io_seconds);
+            std::vector<Point> run(std::max(options.run_size, std::size_t(1)));
+
+            std::size_t n;
+            while ((n = reader.Read(run.data(), run.size())) > 0)
+            {
+                Sort<Point, d>(run.begin(), run.begin() + n);
+
+                runs.push_back(run_files.Add(detail::RunPath(output, nruns++)));
+                detail::PointWriter<Point> writer(runs.back(), options.buffer_size,
+                    stats.io_seconds);
+                writer.Write(run.data(), n);
+                writer.Close();
+
+                stats.npoints += n;
+            }
+        }
+        stats.nruns = runs.size();
+
+        // merge consecutive runs until at most fan_in are left, which are
+        // merged into the output
+        while (runs.size() > fan_in)
+        {
+            std::vector<std::string> merged;
+            for (std::size_t i{0}; i < runs.size(); i += fan_in)
+            {
+                std::vector<std::string> group(runs.begin() + i,
+                    runs.begin() + std::min(i + fan_in, runs.size()));
+
+                merged.push_back(run_files.Add(detail::RunPath(output, nruns++)));
+                detail::MergeRuns<Point, d>(group, merged.back(), options, stats);
+                for (auto const& run : group) { std::remove(run.c_str()); }
+            }
+
+            runs.swap(merged);
+            ++stats.nmerge_passes;
+        }
+
+        if (runs.size() == 1)
+        {
+            // a single run is the output already
+            detail::ScopedTimer io_timer(stats.io_seconds);
+            std::remove(output.c_str());
+            if (std::rename(runs.front().c_str(), output.c_str()) != 0)
+                throw std::runtime_error("cannot rename " + runs.front());
+        }
+        else
+        {
+            detail::MergeRuns<Point, d>(runs, output, options, stats);
+            for (auto const& run : runs) { std::remove(run.c_str()); }
+            ++stats.nmerge_passes;
+        }
+    }
+
+    stats.compute_seconds = total_seconds - stats.io_seconds;
+    return stats;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_EXTERNAL_SORT_HPP
@@ -0,0 +1,163 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_FILE_HPP
+#define ZORDER_KNN_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ZORDER_KNN_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Binary file accessed by large sequential reads or writes, throws
+// std::runtime_error on failure.
+class File
+{
+public:
+    File(std::string const& path, char const* mode)
+        : path_{path}, file_{std::fopen(path.c_str(), mode)}
+    {
+        if (!file_) throw std::runtime_error("cannot open " + path_);
+
+        // reads and writes are buffered by the caller
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+    }
+
+    File(File const&) = delete;
+    File& operator=(File const&) = delete;
+
+    ~File()
+    {
+        if (file_) std::fclose(file_);
+    }
+
+    // Read up to count elements of the given size, returns the number of
+    // elements read, which is less than count only at the end of the file.
+    std::size_t Read(void* data, std::size_t size, std::size_t count)
+    {
+        auto n = std::fread(data, size, count, file_);
+        if (n < count && std::ferror(file_))
+            throw std::runtime_error("cannot read " + path_);
+
+        return n;
+    }
+
+    void Write(void const* data, std::size_t size, std::size_t count)
+    {
+        if (std::fwrite(data, size, count, file_) != count)
+            throw std::runtime_error("cannot write " + path_);
+    }
+
+    // Close the file, reporting errors of flushing written data.
+    void Close()
+    {
+        auto* file = file_;
+        file_ = nullptr;
+        if (std::fclose(file) != 0)
+            throw std::runtime_error("cannot close " + path_);
+    }
+
+private:
+    std::string path_;
+    std::FILE* file_;
+};
+
+#if defined(ZORDER_KNN_HAS_MMAP)
+
+// Read-only memory mapping of a whole file.
+class MappedFile
+{
+public:
+    explicit MappedFile(std::string const& path)
+        : fd_{::open(path.c_str(), O_RDONLY)}, data_{nullptr}, size_{0}
+    {
+        if (fd_ < 0) throw std::runtime_error("cannot open " + path);
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0)
+        {
+            ::close(fd_);
+            throw std::runtime_error("cannot stat " + path);
+        }
+
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ == 0) return;
+
+        auto* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+        if (data == MAP_FAILED)
+        {
+            ::close(fd_);
+            throw std::runtime_error("cannot map " + path);
+        }
+
+        data_ = static_cast<unsigned char const*>(data);
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile()
+    {
+        if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+        ::close(fd_);
+    }
+
+    // Hint that the mapping is about to be read sequentially.
+    void AdviseSequential() const
+    {
+        if (data_)
+        {
+            ::madvise(const_cast<unsigned char*>(data_), size_, MADV_SEQUENTIAL);
+        }
+    }
+
+    unsigned char const* Data() const { return data_; }
+    std::size_t Size() const { return size_; }
+
+private:
+    int fd_;
+    unsigned char const* data_;
+    std::size_t size_;
+};
+
+#endif // ZORDER_KNN_HAS_MMAP
+
+} // namespace detail
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_FILE_HPP
@@ -0,0 +1,237 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_HIGH_DIM_LESS_HPP
+#define ZORDER_KNN_HIGH_DIM_LESS_HPP
+
+#include "less.hpp"
+#include "simd_less.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Coordinates per block of HighDimPoints, a multiple of the lanes of all
+// instruction sets.
+constexpr std::size_t HighDimBlockSize = 16;
+
+// Sign mismatches and equal coordinates of double lanes saturate to the
+// int range.
+inline int
+LaneXorMsb(int64_t y)
+{
+    return static_cast<int>(std::max<int64_t>(std::min<int64_t>(y,
+        std::numeric_limits<int>::max()), std::numeric_limits<int>::min()));
+}
+
+// Fold coordinates [lo, hi) of p and q into the running maximum x of
+// their FloatXorMsb and the coordinate k attaining it, walking from hi
+// down to lo. Ties go to the coordinate preceding in z-order.
+template <typename XorMsb, typename Scalar>
+inline void
+FoldXorMsb(Scalar const* p, Scalar const* q, std::size_t lo, std::size_t hi,
+    int* x, std::size_t* k, simd::NoSimd*)
+{
+    for (std::size_t j{hi}; j-- > lo;)
+    {
+        if (IsNegative(p[j]) != IsNegative(q[j]))
+        {
+            *x = std::numeric_limits<int>::max();
+            *k = j;
+            return;
+        }
+
+        auto y = XorMsb()(p[j], q[j]);
+        if (*x < y)
+        {
+            *x = y;
+            *k = j;
+        }
+    }
+}
+
+template <typename XorMsb, typename Scalar, typename Isa>
+inline void
+FoldXorMsb(Scalar const* p, Scalar const* q, std::size_t lo, std::size_t hi,
+    int* x, std::size_t* k, Isa*)
+{
+    constexpr std::size_t width = Isa::width;
+
+    // the coordinates above the last full vector one by one
+    auto c = hi - (hi - lo) % width;
+    FoldXorMsb<XorMsb>(p, q, c, hi, x, k, static_cast<simd::NoSimd*>(nullptr));
+
+    for (; c > lo && *x != std::numeric_limits<int>::max(); c -= width)
+    {
+        auto y = Isa::XorMsb(Isa::Load(p + c - width), Isa::Load(q + c - width));
+        auto l = static_cast<std::size_t>(UIntLogBase2(Isa::MaxMask(y)));
+
+        auto yl = LaneXorMsb(Isa::Extract(y, l));
+        if (*x < yl)
+        {
+            *x = yl;
+            *k = c - width + l;
+        }
+    }
+}
+
+} // namespace detail
+
+// Less for points of a dimension known only at run time, given as
+// pointers to d contiguous coordinates. Yields the same order as Less.
+// Coordinates are compared a vector at a time if simd_less.hpp supports
+// the instruction set, see SimdLess.
+template <typename Scalar, typename XorMsb = XorMsbTable>
+struct RuntimeLess
+{
+    std::size_t d;
+
+    bool operator()(Scalar const* p, Scalar const* q) const
+    {
+        using Isa = typename detail::simd::PairIsa<Scalar>::type;
+
+        auto x = std::numeric_limits<int>::min();
+        std::size_t k{0};
+        detail::FoldXorMsb<XorMsb>(p, q, 0, d, &x, &k,
+            static_cast<Isa*>(nullptr));
+
+        return p[k] < q[k];
+    }
+};
+
+// Row-major points of a dimension known only at run time, e.g. d = 64 to
+// 128, with the signs and exponent bounds of their coordinates
+// precomputed. Less() compares the sign bits of two points a word at a
+// time, then walks their coordinates in blocks from the highest axis down.
+// It stops as soon as no remaining coordinate can exceed the largest
+// FloatXorMsb found, as the exponents of the coordinates bound it.
+// Yields the same order as Less.
+template <typename Scalar, typename XorMsb = XorMsbTable>
+class HighDimPoints
+{
+public:
+    // The points data[i * d], ..., data[i * d + d - 1] for i < n, which
+    // must outlive *this.
+    HighDimPoints(Scalar const* data, std::size_t n, std::size_t d)
+        : data_(data), n_(n), d_(d)
+        , nwords_((d + 63) / 64)
+        , nblocks_((d + detail::HighDimBlockSize - 1) / detail::HighDimBlockSize)
+        , signs_(n * nwords_, 0)
+        , bounds_(n * nblocks_)
+    {
+        for (std::size_t i{0}; i < n; ++i)
+        {
+            auto const* p = data + i * d;
+            auto* signs = signs_.data() + i * nwords_;
+            auto* bounds = bounds_.data() + i * nblocks_;
+
+            auto bound = std::numeric_limits<int>::min();
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                if (detail::IsNegative(p[j])) signs[j / 64] |= uint64_t(1) << (j % 64);
+
+                bound = std::max<int>(bound, detail::CoordinateExp(p[j]));
+                if ((j + 1) % detail::HighDimBlockSize == 0 || j + 1 == d)
+                    bounds[j / detail::HighDimBlockSize] = bound;
+            }
+        }
+    }
+
+    std::size_t Size() const { return n_; }
+
+    std::size_t Dim() const { return d_; }
+
+    Scalar const* operator[](std::size_t i) const { return data_ + i * d_; }
+
+    // Point i precedes point j in z-order.
+    bool Less(std::size_t i, std::size_t j) const
+    {
+        using Isa = typename detail::simd::PairIsa<Scalar>::type;
+
+        auto const* p = (*this)[i];
+        auto const* q = (*this)[j];
+
+        // a sign mismatch decides, the highest axis first
+        auto const* ps = signs_.data() + i * nwords_;
+        auto const* qs = signs_.data() + j * nwords_;
+        for (std::size_t w{nwords_}; w-- > 0;)
+        {
+            if (auto diff = ps[w] ^ qs[w])
+            {
+                auto k = w * 64 + static_cast<std::size_t>(detail::UIntLogBase2(diff));
+                return p[k] < q[k];
+            }
+        }
+
+        // bounds[b] bounds the coordinates of blocks 0 to b
+        auto const* pb = bounds_.data() + i * nblocks_;
+        auto const* qb = bounds_.data() + j * nblocks_;
+
+        auto x = std::numeric_limits<int>::min();
+        std::size_t k{0};
+        for (std::size_t b{nblocks_}; b-- > 0;)
+        {
+            if (std::max(pb[b], qb[b]) <= x) break;
+
+            auto lo = b * detail::HighDimBlockSize;
+            auto hi = std::min(lo + detail::HighDimBlockSize, d_);
+            detail::FoldXorMsb<XorMsb>(p, q, lo, hi, &x, &k,
+                static_cast<Isa*>(nullptr));
+        }
+
+        return p[k] < q[k];
+    }
+
+    // The indices of the points in z-order.
+    template <typename Index = std::size_t>
+    std::vector<Index> SortPermutation() const
+    {
+        std::vector<Index> perm(n_);
+        for (std::size_t i{0}; i < n_; ++i) { perm[i] = static_cast<Index>(i); }
+
+        std::sort(perm.begin(), perm.end(), [this](Index i, Index j) {
+            return Less(static_cast<std::size_t>(i), static_cast<std::size_t>(j));
+        });
+
+        return perm;
+    }
+
+private:
+    Scalar const* data_;
+    std::size_t n_, d_;
+    std::size_t nwords_, nblocks_;
+    std::vector<uint64_t> signs_;
+    std::vector<int> bounds_;
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_HIGH_DIM_LESS_HPP
@@ -0,0 +1,242 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_HILBERT_HPP
+#define ZORDER_KNN_HILBERT_HPP
+
+#include "less.hpp"
+#include "key.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Rotate the lowest n bits of b.
+inline unsigned
+RotateRight(unsigned b, unsigned r, unsigned n)
+{
+    r %= n;
+    auto mask = (1u << n) - 1;
+    return ((b >> r) | (b << (n - r))) & mask;
+}
+
+inline unsigned
+RotateLeft(unsigned b, unsigned r, unsigned n)
+{
+    return RotateRight(b, n - r % n, n);
+}
+
+inline unsigned
+GrayCodeInverse(unsigned g)
+{
+    unsigned i{0};
+    for (; g != 0; g >>= 1) { i ^= g; }
+
+    return i;
+}
+
+inline unsigned
+TrailingSetBits(unsigned i)
+{
+    unsigned n{0};
+    for (; i & 1; i >>= 1) { ++n; }
+
+    return n;
+}
+
+// Transitions of the Hilbert curve in d dimensions following Hamilton,
+// "Compact Hilbert Indices", 2006. A state is the entry point e and the
+// direction of a cell, the bits at a level of the coordinates of a point,
+// bit j for axis j, select its child cell. Digit() is the position of the
+// child cell along the curve and Next() the state of the child cell.
+template <std::size_t d>
+struct HilbertTable
+{
+    static constexpr unsigned nchildren = 1u << d;
+    static constexpr unsigned nstates = d * nchildren;
+
+    HilbertTable()
+        : digit(nstates * nchildren), next(nstates * nchildren),
+          prefix(nchildren)
+    {
+        for (unsigned e{0}; e < nchildren; ++e)
+        {
+            for (unsigned dir{0}; dir < d; ++dir)
+            {
+                for (unsigned bits{0}; bits < nchildren; ++bits)
+                {
+                    auto w = GrayCodeInverse(RotateRight(bits ^ e, dir + 1, d));
+
+                    // entry point and direction of child w
+                    auto w_e = (w == 0) ? 0 : ((w - 1) & ~1u) ^ (((w - 1) & ~1u) >> 1);
+                    auto w_dir = (w == 0) ? 0 : TrailingSetBits((w % 2 == 0) ? w - 1 : w) % d;
+
+                    auto i = (e * d + dir) * nchildren + bits;
+                    digit[i] = static_cast<uint8_t>(w);
+                    next[i] = static_cast<uint16_t>(
+                        (e ^ RotateLeft(w_e, dir + 1, d)) * d + (dir + w_dir + 1) % d);
+                }
+            }
+        }
+
+        // The states after the sign level and any number of levels above
+        // the most significant bit, whose bits are the inverted sign bits,
+        // repeat after a preperiod.
+        for (unsigned signs{0}; signs < nchildren; ++signs)
+        {
+            auto& states = prefix[signs].states;
+            auto bits = ~signs & (nchildren - 1);
+            auto state = Next(0, signs);
+
+            while (std::find(states.begin(), states.end(), state) == states.end())
+            {
+                states.push_back(state);
+                state = Next(state, bits);
+            }
+
+            prefix[signs].preperiod = static_cast<std::size_t>(
+                std::find(states.begin(), states.end(), state) - states.begin());
+        }
+    }
+
+    unsigned Digit(unsigned state, unsigned bits) const
+    {
+        return digit[state * nchildren + bits];
+    }
+
+    unsigned Next(unsigned state, unsigned bits) const
+    {
+        return next[state * nchildren + bits];
+    }
+
+    // State after the sign level and nlevels levels above the most
+    // significant bit.
+    unsigned Prefix(unsigned signs, std::size_t nlevels) const
+    {
+        auto const& p = prefix[signs];
+        if (nlevels < p.states.size()) return p.states[nlevels];
+
+        auto period = p.states.size() - p.preperiod;
+        return p.states[p.preperiod + (nlevels - p.preperiod) % period];
+    }
+
+    struct PrefixStates
+    {
+        std::vector<unsigned> states;
+        std::size_t preperiod;
+    };
+
+    std::vector<uint8_t> digit;
+    std::vector<uint16_t> next;
+    std::vector<PrefixStates> prefix;
+};
+
+template <typename UInt>
+inline unsigned
+FixedPointBit(FixedPoint<UInt> const& x, int y)
+{
+    auto s = y - x.exp;
+    return (s >= 0 && s < static_cast<int>(sizeof(UInt) * 8))
+        ? static_cast<unsigned>((x.sig >> s) & 1) : 0u;
+}
+
+} // namespace detail
+
+// Hilbert curve order of points with floating point coordinates. Like
+// Less, it is defined on the binary expansion of the coordinates without
+// quantizing them: the first level splits each axis at zero, where zero
+// belongs to the non-negative numbers, and the following levels split
+// the magnitudes bit by bit, starting from the largest finite exponent
+// of Scalar. The magnitude bits of negative coordinates are inverted, so
+// that the order of each level follows the order of the coordinates. The
+// comparison skips the levels above the most significant bit of the
+// coordinates by a precomputed table.
+template <typename Point, std::size_t d>
+struct HilbertLess
+{
+    static_assert(d >= 2 && d <= 6, "HilbertLess requires 2 <= d <= 6");
+
+    bool operator()(Point const& p, Point const& q) const
+    {
+        using Scalar = detail::PointScalar<Point>;
+        using UInt = decltype(detail::FloatToUInt(Scalar(0.0)));
+        constexpr auto zero = Scalar(0.0);
+        constexpr int y_top = std::numeric_limits<Scalar>::max_exponent - 1;
+
+        static detail::HilbertTable<d> const table;
+
+        unsigned p_signs{0}, q_signs{0};
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            p_signs |= static_cast<unsigned>(!(p[j] < zero)) << j;
+            q_signs |= static_cast<unsigned>(!(q[j] < zero)) << j;
+        }
+
+        if (p_signs != q_signs)
+            return table.Digit(0, p_signs) < table.Digit(0, q_signs);
+
+        // the most significant differing bit x and set bit y_max
+        auto x = std::numeric_limits<int>::min();
+        auto y_max = std::numeric_limits<int>::min();
+        detail::FixedPoint<UInt> pf[d], qf[d];
+
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            pf[j] = detail::FloatToFixedPoint(p[j]);
+            qf[j] = detail::FloatToFixedPoint(q[j]);
+
+            x = std::max(x, detail::FloatXorMsb(p[j], q[j]));
+            if (pf[j].sig) y_max = std::max(y_max, detail::FixedPointMsb(pf[j]));
+            if (qf[j].sig) y_max = std::max(y_max, detail::FixedPointMsb(qf[j]));
+        }
+
+        if (x == std::numeric_limits<int>::min()) return false;
+
+        auto inverted = ~p_signs & (table.nchildren - 1);
+        auto bits = [&](detail::FixedPoint<UInt> const* f, int y) {
+            unsigned b{0};
+            for (std::size_t j{0}; j < d; ++j)
+            {
+                b |= detail::FixedPointBit(f[j], y) << j;
+            }
+
+            return b ^ inverted;
+        };
+
+        auto state = table.Prefix(p_signs, static_cast<std::size_t>(y_top - y_max));
+        for (auto y = y_max; y > x; --y) { state = table.Next(state, bits(pf, y)); }
+
+        return table.Digit(state, bits(pf, x)) < table.Digit(state, bits(qf, x));
+    }
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_HILBERT_HPP
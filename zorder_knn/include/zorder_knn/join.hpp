@@ -0,0 +1,149 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_JOIN_HPP
+#define ZORDER_KNN_JOIN_HPP
+
+#include "batch_knn.hpp"
+#include "knn.hpp"
+#include "box.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Call f(i, j) for all pairs of a[i], i in [a0, a1), and b[j], j in
+// [b0, b1), whose squared distance does not exceed r2. Both ranges are
+// split recursively along the cells of the z-order, the larger one first,
+// and a pair of ranges is skipped if the common cells of their first and
+// last points are farther apart than the radius.
+template <typename Point, std::size_t d, typename F>
+void
+JoinRanges(std::vector<Point> const& a, std::size_t a0, std::size_t a1,
+    std::vector<Point> const& b, std::size_t b0, std::size_t b1,
+    PointScalar<Point> r2, F& f)
+{
+    constexpr std::size_t leaf_size = 32;
+
+    if (a0 >= a1 || b0 >= b1) return;
+
+    auto cell_a = CommonCell<Point, d>(a[a0], a[a1 - 1]);
+    auto cell_b = CommonCell<Point, d>(b[b0], b[b1 - 1]);
+    if (SquaredDistance<Point, d>(cell_a, cell_b) > r2) return;
+
+    auto na = a1 - a0, nb = b1 - b0;
+    if (na > leaf_size || nb > leaf_size)
+    {
+        // a range of equal points cannot be split
+        auto mid_a = SplitRange<Point, d>(a, a0, a1);
+        auto mid_b = SplitRange<Point, d>(b, b0, b1);
+
+        if (mid_a != a1 && (na >= nb || mid_b == b1))
+        {
+            JoinRanges<Point, d>(a, a0, mid_a, b, b0, b1, r2, f);
+            JoinRanges<Point, d>(a, mid_a, a1, b, b0, b1, r2, f);
+            return;
+        }
+
+        if (mid_b != b1)
+        {
+            JoinRanges<Point, d>(a, a0, a1, b, b0, mid_b, r2, f);
+            JoinRanges<Point, d>(a, a0, a1, b, mid_b, b1, r2, f);
+            return;
+        }
+    }
+
+    for (auto i = a0; i < a1; ++i)
+    {
+        for (auto j = b0; j < b1; ++j)
+        {
+            if (SquaredDistance<Point, d>(a[i], b[j]) <= r2) f(i, j);
+        }
+    }
+}
+
+} // namespace detail
+
+// Call f(i, j) for all pairs of points a_sorted[i] and b_sorted[j] within
+// distance r of each other, where both arrays are sorted in z-order by
+// Less. The arrays are traversed at the same time as implicit trees of
+// z-order cells, so neither requires an index. The order of the pairs is
+// unspecified.
+template <typename Point, std::size_t d, typename F>
+void
+ForEachPairWithin(std::vector<Point> const& a_sorted,
+    std::vector<Point> const& b_sorted, detail::PointScalar<Point> r, F f)
+{
+    if (r < detail::PointScalar<Point>(0)) return;
+    detail::JoinRanges<Point, d>(a_sorted, 0, a_sorted.size(), b_sorted, 0,
+        b_sorted.size(), r * r, f);
+}
+
+// Pairs of indices (i, j) of all points a_sorted[i] and b_sorted[j]
+// within distance r of each other, in lexicographic order.
+template <typename Point, std::size_t d>
+std::vector<std::pair<std::size_t, std::size_t>>
+FindPairsWithin(std::vector<Point> const& a_sorted,
+    std::vector<Point> const& b_sorted, detail::PointScalar<Point> r)
+{
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    ForEachPairWithin<Point, d>(a_sorted, b_sorted, r,
+        [&pairs](std::size_t i, std::size_t j) { pairs.emplace_back(i, j); });
+    std::sort(pairs.begin(), pairs.end());
+
+    return pairs;
+}
+
+// Find the k nearest neighbors within b_sorted of each point of a_sorted,
+// where both arrays are sorted in z-order by Less. The points of a_sorted
+// are swept in order alongside b_sorted as by FindKNearestBatch(), whose
+// result this is, without sorting them first.
+//
+// Returns a_sorted.size() * min(k, n) indices into b_sorted, where the
+// neighbors of a_sorted[i] in order of increasing distance occupy the
+// range [i * k, (i + 1) * k).
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+NearestJoin(std::vector<Point> const& a_sorted,
+    std::vector<Point> const& b_sorted, std::size_t k = 1, bool exact = true)
+{
+    k = std::min(k, b_sorted.size());
+    if (k == 0 || a_sorted.empty()) return {};
+
+    std::vector<std::size_t> neighbors(a_sorted.size() * k);
+    detail::KnnSweep<Point, d>(b_sorted, a_sorted,
+        [](std::size_t i) { return i; }, 0, a_sorted.size(), k, exact,
+        neighbors.data());
+
+    return neighbors;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_JOIN_HPP
@@ -0,0 +1,368 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_KEY_HPP
+#define ZORDER_KNN_KEY_HPP
+
+#include "less.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// The set bits of |x| are those of sig shifted by exp, i.e.
+// |x| = sig * 2^exp.
+template <typename UInt>
+struct FixedPoint
+{
+    UInt sig;
+    int exp;
+};
+
+template <typename Scalar>
+inline auto
+FloatToFixedPoint(Scalar x) -> FixedPoint<decltype(FloatToUInt(x))>
+{
+    auto xi = FloatToUInt(x);
+    return { FloatFullSig(xi), FloatExp(xi) - significand<Scalar>::nbits };
+}
+
+inline FixedPoint<uint32_t>
+FloatToFixedPoint(BFloat16 x)
+{
+    return FloatToFixedPoint(static_cast<float>(x));
+}
+
+template <typename Int, typename std::enable_if<
+    std::is_integral<Int>::value, int>::type = 0>
+inline FixedPoint<IntMagnitude<Int>>
+FloatToFixedPoint(Int x)
+{
+    return { IntAbs(x), 0 };
+}
+
+template <typename UInt>
+inline int
+FixedPointMsb(FixedPoint<UInt> const& x)
+{
+    assert(x.sig > 0);
+    return x.exp + UIntLogBase2(x.sig);
+}
+
+template <typename UInt>
+inline int
+FixedPointLsb(FixedPoint<UInt> const& x)
+{
+    assert(x.sig > 0);
+    return x.exp + UIntLogBase2(static_cast<UInt>(x.sig & (~x.sig + 1)));
+}
+
+// Projection of an element to itself.
+struct Identity
+{
+    template <typename T>
+    T const& operator()(T const& x) const { return x; }
+};
+
+// Apply the projection proj to x, where proj is a function object or a
+// pointer to a data member or const member function of x.
+template <typename Proj, typename T>
+inline auto
+Invoke(Proj const& proj, T const& x) -> decltype(proj(x))
+{
+    return proj(x);
+}
+
+template <typename M, typename C, typename T>
+inline auto
+Invoke(M C::* member, T const& x) -> decltype(x.*member)
+{
+    return x.*member;
+}
+
+template <typename R, typename C, typename T>
+inline R
+Invoke(R (C::* member)() const, T const& x)
+{
+    return (x.*member)();
+}
+
+template <typename Point>
+using PointScalar = typename std::decay<decltype(std::declval<Point>()[0])>::type;
+
+inline void
+KeyToggleBit(uint64_t* key, std::size_t nwords, std::size_t i)
+{
+    key[nwords - 1 - i / 64] ^= uint64_t(1) << (i % 64);
+}
+
+// Toggle the set bits of bits shifted by i.
+inline void
+KeyToggleBits(uint64_t* key, std::size_t nwords, std::size_t i, uint64_t bits)
+{
+    auto w = nwords - 1 - i / 64;
+    auto s = i % 64;
+
+    key[w] ^= bits << s;
+    if (s > 0 && (bits >> (64 - s)) != 0)
+        key[w - 1] ^= bits >> (64 - s);
+}
+
+// Moves bit i of a byte to bit i * d.
+template <std::size_t d>
+struct SpreadTable
+{
+    SpreadTable()
+    {
+        for (unsigned b{0}; b < 256; ++b)
+        {
+            table[b] = 0;
+            for (std::size_t i{0}; i < 8; ++i)
+            {
+                table[b] |= static_cast<uint64_t>((b >> i) & 1) << (i * d);
+            }
+        }
+    }
+
+    uint64_t table[256];
+};
+
+// Toggle bit k of sig at bit position i + k * d of the key.
+template <std::size_t d, typename UInt>
+inline void
+KeyToggleSpread(uint64_t* key, std::size_t nwords, std::size_t i, UInt sig,
+    std::true_type /* d <= 8 */)
+{
+    static SpreadTable<d> const spread;
+
+    for (; sig != 0; sig >>= 8, i += 8 * d)
+    {
+        KeyToggleBits(key, nwords, i, spread.table[sig & 0xff]);
+    }
+}
+
+template <std::size_t d, typename UInt>
+inline void
+KeyToggleSpread(uint64_t* key, std::size_t nwords, std::size_t i, UInt sig,
+    std::false_type /* d <= 8 */)
+{
+    for (; sig != 0; sig >>= 1, i += d)
+    {
+        key[nwords - 1 - i / 64] ^= static_cast<uint64_t>(sig & 1) << (i % 64);
+    }
+}
+
+} // namespace detail
+
+// Bit layout of fixed-width morton keys for a set of points. The
+// magnitude bits of all coordinates lie within [bit_min, bit_max]. A key
+// starts with the d sign bits followed by the magnitude bits of all d
+// coordinates interleaved from bit_max down to bit_min, and occupies
+// nwords 64-bit words, most significant word first.
+struct KeyLayout
+{
+    int bit_min;
+    int bit_max;
+    std::size_t nbits;
+    std::size_t nwords;
+
+    // Per coordinate, the mask of all its magnitude bits. Negative
+    // coordinates store their magnitude bits inverted.
+    std::vector<uint64_t> masks;
+};
+
+// Range [bit_min, bit_max] of the magnitude bits of the coordinates of
+// the given points, bit_min > bit_max if all coordinates are zero.
+struct KeyBitRange
+{
+    int bit_min = std::numeric_limits<int>::max();
+    int bit_max = std::numeric_limits<int>::min();
+
+    void Merge(KeyBitRange const& r)
+    {
+        bit_min = std::min(bit_min, r.bit_min);
+        bit_max = std::max(bit_max, r.bit_max);
+    }
+};
+
+// The points are given by proj(*it) for it in [first, last).
+template <typename Point, std::size_t d, typename InputIt,
+    typename Proj = detail::Identity>
+KeyBitRange
+MakeKeyBitRange(InputIt first, InputIt last, Proj proj = Proj())
+{
+    KeyBitRange range;
+
+    for (; first != last; ++first)
+    {
+        Point const& p = detail::Invoke(proj, *first);
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            auto x = detail::FloatToFixedPoint(p[j]);
+            if (x.sig == 0) continue;
+
+            range.bit_min = std::min(range.bit_min, detail::FixedPointLsb(x));
+            range.bit_max = std::max(range.bit_max, detail::FixedPointMsb(x));
+        }
+    }
+
+    return range;
+}
+
+template <std::size_t d>
+KeyLayout
+MakeKeyLayout(KeyBitRange range)
+{
+    // all coordinates are zero
+    if (range.bit_min > range.bit_max) { range.bit_min = range.bit_max = 0; }
+
+    KeyLayout layout;
+    layout.bit_min = range.bit_min;
+    layout.bit_max = range.bit_max;
+
+    auto nlevels = static_cast<std::size_t>(range.bit_max - range.bit_min + 1);
+    layout.nbits  = (nlevels + 1) * d;
+    layout.nwords = (layout.nbits + 63) / 64;
+
+    layout.masks.assign(d * layout.nwords, 0);
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        for (std::size_t i{0}; i < nlevels; ++i)
+        {
+            detail::KeyToggleBit(layout.masks.data() + j * layout.nwords,
+                layout.nwords, i * d + j);
+        }
+    }
+
+    return layout;
+}
+
+template <typename Point, std::size_t d, typename InputIt,
+    typename Proj = detail::Identity>
+KeyLayout
+MakeKeyLayout(InputIt first, InputIt last, Proj proj = Proj())
+{
+    return MakeKeyLayout<d>(MakeKeyBitRange<Point, d>(first, last, proj));
+}
+
+namespace detail
+{
+
+// Add the bits of coordinate j, x, to the key, which must have been
+// cleared before.
+template <std::size_t d, typename Scalar>
+void
+KeyAddCoordinate(KeyLayout const& layout, std::size_t j, Scalar x,
+    uint64_t* key)
+{
+    auto nwords = layout.nwords;
+    auto nlevels = static_cast<std::size_t>(layout.bit_max - layout.bit_min + 1);
+
+    // Negative coordinates precede non-negative ones, the sign bits
+    // precede all magnitude bits.
+    if (IsNegative(x))
+    {
+        auto const* mask = layout.masks.data() + j * nwords;
+        for (std::size_t w{0}; w < nwords; ++w) { key[w] |= mask[w]; }
+    }
+    else
+    {
+        KeyToggleBit(key, nwords, nlevels * d + j);
+    }
+
+    auto fp = FloatToFixedPoint(x);
+    assert(fp.sig == 0 || (FixedPointLsb(fp) >= layout.bit_min &&
+                           FixedPointMsb(fp) <= layout.bit_max));
+
+    if (fp.sig == 0) return;
+
+    // skip trailing zeros which may lie below bit_min
+    auto lsb = FixedPointLsb(fp);
+    KeyToggleSpread<d>(key, nwords,
+        static_cast<std::size_t>(lsb - layout.bit_min) * d + j,
+        fp.sig >> (lsb - fp.exp), std::integral_constant<bool, (d <= 8)>());
+}
+
+} // namespace detail
+
+// Compute the key of p according to the layout, which must have been
+// obtained from a point set containing p. Comparing two keys as unsigned
+// integers yields the same order as Less<Point, d>. Coordinates are
+// expected to be finite.
+template <typename Point, std::size_t d>
+void
+MakeKey(KeyLayout const& layout, Point const& p, uint64_t* key)
+{
+    std::fill(key, key + layout.nwords, uint64_t(0));
+
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        detail::KeyAddCoordinate<d>(layout, j, p[j], key);
+    }
+}
+
+// Compute the keys of the points proj(*it) for it in [first, last), key
+// i occupies the words [i * layout.nwords, (i + 1) * layout.nwords).
+template <typename Point, std::size_t d, typename ForwardIt,
+    typename Proj = detail::Identity>
+std::vector<uint64_t>
+MakeKeys(KeyLayout const& layout, ForwardIt first, ForwardIt last,
+    Proj proj = Proj())
+{
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    std::vector<uint64_t> keys(n * layout.nwords);
+
+    for (std::size_t i{0}; i < n; ++i, ++first)
+    {
+        MakeKey<Point, d>(layout, detail::Invoke(proj, *first),
+            keys.data() + i * layout.nwords);
+    }
+
+    return keys;
+}
+
+inline bool
+KeyLess(uint64_t const* k0, uint64_t const* k1, std::size_t nwords)
+{
+    for (std::size_t w{0}; w < nwords; ++w)
+    {
+        if (k0[w] != k1[w])
+            return k0[w] < k1[w];
+    }
+
+    return false;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_KEY_HPP
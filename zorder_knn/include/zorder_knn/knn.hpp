@@ -0,0 +1,367 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_KNN_HPP
+#define ZORDER_KNN_KNN_HPP
+
+#include "sort.hpp"
+#include "box.hpp"
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Max-heap of the k nearest neighbors found so far, ordered by squared
+// distance and index.
+template <typename Scalar>
+class KnnHeap
+{
+public:
+    using Neighbor = std::pair<Scalar, std::size_t>;
+
+    explicit KnnHeap(std::size_t k) : k_{k} { heap_.reserve(k); }
+
+    void Clear() { heap_.clear(); }
+    bool Full() const { return heap_.size() == k_; }
+
+    // Squared distance of the k-th nearest neighbor.
+    Scalar Bound() const
+    {
+        return Full() ? heap_.front().first : std::numeric_limits<Scalar>::max();
+    }
+
+    void Push(Scalar dist2, std::size_t i)
+    {
+        Neighbor n{dist2, i};
+        if (!Full())
+        {
+            heap_.push_back(n);
+            std::push_heap(heap_.begin(), heap_.end());
+        }
+        else if (n < heap_.front())
+        {
+            std::pop_heap(heap_.begin(), heap_.end());
+            heap_.back() = n;
+            std::push_heap(heap_.begin(), heap_.end());
+        }
+    }
+
+    // Neighbors in order of increasing distance, Clear() the heap before
+    // pushing further neighbors.
+    std::vector<Neighbor>& Sorted()
+    {
+        std::sort_heap(heap_.begin(), heap_.end());
+        return heap_;
+    }
+
+private:
+    std::size_t k_;
+    std::vector<Neighbor> heap_;
+};
+
+// Axis-aligned box around p containing all points whose squared distance
+// to p does not exceed dist2. The radius is padded to account for
+// rounding errors of the distance computation.
+template <typename Point, std::size_t d>
+Box<Point>
+BallBox(Point const& p, PointScalar<Point> dist2)
+{
+    using Scalar = PointScalar<Point>;
+    constexpr auto eps = std::numeric_limits<Scalar>::epsilon();
+
+    auto r = std::sqrt(dist2);
+    r += r * static_cast<Scalar>(d + 2) * eps;
+
+    Box<Point> box{p, p};
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        box.lo[j] = p[j] - r;
+        box.hi[j] = p[j] + r;
+    }
+
+    return box;
+}
+
+// Index of the first point within the z-sorted range [first, last) that
+// differs from points[first] at the most significant bit of the z-order
+// at which points[first] and points[last - 1] differ, i.e. the split of
+// their common cell. Returns last if the points are equal.
+template <typename Point, std::size_t d>
+std::size_t
+SplitRange(std::vector<Point> const& points, std::size_t first,
+    std::size_t last)
+{
+    using Scalar = PointScalar<Point>;
+    constexpr auto zero = Scalar(0.0);
+
+    auto const& p = points[first];
+    auto const& q = points[last - 1];
+
+    auto x = std::numeric_limits<int>::min();
+    std::size_t k{0};
+    auto sign = false;
+
+    for (std::size_t j{d}; j-- > 0;)
+    {
+        // the signs precede all other bits
+        if ((p[j] < zero) != (q[j] < zero))
+        {
+            k = j;
+            sign = true;
+            break;
+        }
+
+        auto y = FloatXorMsb(p[j], q[j]);
+        if (x < y)
+        {
+            x = y;
+            k = j;
+        }
+    }
+
+    if (!sign && x == std::numeric_limits<int>::min()) return last;
+
+    auto begin = points.begin();
+    return static_cast<std::size_t>(std::partition_point(begin + first,
+        begin + last, [&](Point const& r) {
+            return sign ? (r[k] < zero) == (p[k] < zero)
+                        : FloatXorMsb(p[k], r[k]) < x;
+        }) - begin);
+}
+
+// Search the z-sorted points in [first, last) for neighbors of p closer
+// than the current k-th nearest neighbor. The range is split recursively
+// along the cells of the z-order, the part closer to the z-position pos
+// of p first, and skipped if the common cell of its first and last point
+// lies beyond the current k-th nearest neighbor. Points in
+// [skip_lo, skip_hi) are skipped.
+template <typename Point, std::size_t d, typename Id>
+void
+KnnSearchRange(std::vector<Point> const& points, Point const& p,
+    std::size_t pos, std::size_t first, std::size_t last,
+    std::size_t skip_lo, std::size_t skip_hi, Id id,
+    KnnHeap<PointScalar<Point>>& heap)
+{
+    // scanning a few points beats pruning them cell by cell
+    constexpr std::size_t leaf_size = 64;
+
+    if (first >= last || (first >= skip_lo && last <= skip_hi)) return;
+
+    auto cell = CommonCell<Point, d>(points[first], points[last - 1]);
+    if (SquaredDistance<Point, d>(p, cell) > heap.Bound()) return;
+
+    auto mid = last - first <= leaf_size ? last
+        : SplitRange<Point, d>(points, first, last);
+
+    if (mid == last)
+    {
+        for (auto j = first; j < last; ++j)
+        {
+            if (j >= skip_lo && j < skip_hi) continue;
+            heap.Push(SquaredDistance<Point, d>(p, points[j]), id(j));
+        }
+
+        return;
+    }
+
+    if (pos < mid)
+    {
+        KnnSearchRange<Point, d>(points, p, pos, first, mid, skip_lo, skip_hi, id, heap);
+        KnnSearchRange<Point, d>(points, p, pos, mid, last, skip_lo, skip_hi, id, heap);
+    }
+    else
+    {
+        KnnSearchRange<Point, d>(points, p, pos, mid, last, skip_lo, skip_hi, id, heap);
+        KnnSearchRange<Point, d>(points, p, pos, first, mid, skip_lo, skip_hi, id, heap);
+    }
+}
+
+// Push the candidates in [lo, hi) except for i_skip onto the heap.
+template <typename Point, std::size_t d, typename Id>
+void
+KnnWindow(std::vector<Point> const& points, Point const& p,
+    std::size_t i_skip, std::size_t lo, std::size_t hi, Id id,
+    KnnHeap<PointScalar<Point>>& heap)
+{
+    for (auto j = lo; j < hi; ++j)
+    {
+        if (j == i_skip) continue;
+        heap.Push(SquaredDistance<Point, d>(p, points[j]), id(j));
+    }
+}
+
+// Refine the k nearest neighbors of p found among the candidates in
+// [lo, hi), where pos is the z-position of p. Unless the bounding box of
+// the ball around p enclosing the k nearest candidates is covered by the
+// z-range of the candidates, the search continues within the z-range of
+// the box. The heap is filled with the neighbors' ids, id(j) for
+// points[j].
+template <typename Point, std::size_t d, typename Id>
+void
+KnnRefine(std::vector<Point> const& points, Point const& p,
+    std::size_t pos, std::size_t lo, std::size_t hi, Id id,
+    KnnHeap<PointScalar<Point>>& heap)
+{
+    Less<Point, d> less;
+
+    if (!heap.Full()) return;
+
+    auto box = BallBox<Point, d>(p, heap.Bound());
+
+    auto covered_lo = lo == 0 || less(points[lo - 1], box.lo);
+    auto covered_hi = hi == points.size() || less(box.hi, points[hi]);
+    if (covered_lo && covered_hi) return;
+
+    auto begin = points.begin();
+    auto first = std::lower_bound(begin, begin + lo, box.lo, less) - begin;
+    auto last = std::upper_bound(begin + hi, points.end(), box.hi, less) - begin;
+
+    // the candidates are already part of the heap
+    pos = std::min(std::max(pos, lo), hi - 1);
+    KnnSearchRange<Point, d>(points, p, pos, static_cast<std::size_t>(first),
+        static_cast<std::size_t>(last), lo, hi, id, heap);
+}
+
+// First index of the window of candidates, centered at pos as far as
+// [0, n) permits.
+inline std::size_t
+KnnWindowBegin(std::size_t n, std::size_t pos, std::size_t k,
+    std::size_t window)
+{
+    return std::min(pos - std::min(pos, k), n - window);
+}
+
+// Find the k nearest neighbors of the z-sorted points in [begin, end),
+// where points[i] is the original point perm[i], and store them in the
+// rows of the graph. The candidate windows of the first and last k points
+// extend beyond the range.
+template <typename Point, std::size_t d>
+void
+KnnGraphRows(std::vector<Point> const& points,
+    std::vector<std::size_t> const& perm, std::size_t k, std::size_t begin,
+    std::size_t end, std::size_t* graph)
+{
+    auto n = points.size();
+    KnnHeap<PointScalar<Point>> heap(k);
+
+    auto id = [&perm](std::size_t j) { return perm[j]; };
+
+    auto window = std::min(2 * k + 1, n);
+    for (auto i = begin; i < end; ++i)
+    {
+        auto lo = KnnWindowBegin(n, i, k, window);
+        KnnWindow<Point, d>(points, points[i], i, lo, lo + window, id, heap);
+        KnnRefine<Point, d>(points, points[i], i, lo, lo + window, id, heap);
+
+        auto const& neighbors = heap.Sorted();
+        auto* row = graph + perm[i] * k;
+        for (std::size_t m{0}; m < k; ++m) { row[m] = neighbors[m].second; }
+        heap.Clear();
+    }
+}
+
+} // namespace detail
+
+// Build the exact k-nearest neighbor graph of the points following
+// Connor and Kumar: the points are sorted in z-order, the k nearest
+// neighbors among the 2k points surrounding each point in z-order serve
+// as candidates, and the candidates are refined by searching the z-range
+// of the bounding box of the ball enclosing them unless it is covered by
+// the candidates already.
+//
+// Returns n * k indices into points, where the k neighbors of point i in
+// order of increasing distance (ties broken by index) occupy the range
+// [i * k, (i + 1) * k). Throws std::invalid_argument unless k < n or
+// k == 0.
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+BuildKnnGraph(std::vector<Point> const& points, std::size_t k)
+{
+    auto n = points.size();
+    if (k == 0) return {};
+    if (k >= n) throw std::invalid_argument("k >= number of points");
+
+    auto perm = SortPermutation<Point, d>(points.begin(), points.end());
+
+    std::vector<Point> sorted;
+    sorted.reserve(n);
+    for (auto i : perm) { sorted.push_back(points[i]); }
+
+    std::vector<std::size_t> graph(n * k);
+    detail::KnnGraphRows<Point, d>(sorted, perm, k, 0, n, graph.data());
+
+    return graph;
+}
+
+// Find the k nearest neighbors of the query within the points sorted in
+// z-order by Less, without any additional index. The query's z-position
+// is found by binary search and the 2k points surrounding it serve as
+// candidates. If exact is set, the candidates are refined as in
+// BuildKnnGraph() and the result is exact, otherwise it is approximate.
+//
+// Returns min(k, n) indices into sorted_points in order of increasing
+// distance to the query, ties broken by index.
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+FindKNearest(std::vector<Point> const& sorted_points, Point const& query,
+    std::size_t k, bool exact = true)
+{
+    auto n = sorted_points.size();
+    k = std::min(k, n);
+    if (k == 0) return {};
+
+    auto pos = static_cast<std::size_t>(std::lower_bound(sorted_points.begin(),
+        sorted_points.end(), query, Less<Point, d>()) - sorted_points.begin());
+
+    auto id = [](std::size_t j) { return j; };
+    detail::KnnHeap<detail::PointScalar<Point>> heap(k);
+
+    auto window = std::min(2 * k, n);
+    auto lo = detail::KnnWindowBegin(n, pos, k, window);
+    auto npos = std::numeric_limits<std::size_t>::max();
+    detail::KnnWindow<Point, d>(sorted_points, query, npos, lo, lo + window, id, heap);
+    if (exact)
+    {
+        detail::KnnRefine<Point, d>(sorted_points, query, pos, lo, lo + window,
+            id, heap);
+    }
+
+    std::vector<std::size_t> neighbors;
+    neighbors.reserve(k);
+    for (auto const& neighbor : heap.Sorted()) { neighbors.push_back(neighbor.second); }
+
+    return neighbors;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_KNN_HPP
@@ -23,11 +23,19 @@
 #ifndef ZORDER_KNN_LESS_HPP
 #define ZORDER_KNN_LESS_HPP
 
+#include "bfloat16.hpp"
+
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <type_traits>
 #include <algorithm>
 #include <cassert>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace zorder_knn
 {
 
@@ -66,17 +74,52 @@ FloatToUInt(double x)
     return xi;
 }
 
+#if defined(ZORDER_KNN_FLOAT16)
+inline uint16_t
+FloatToUInt(_Float16 x)
+{
+    static_assert(
+        sizeof(_Float16) == sizeof(uint16_t),
+        "sizeof(_Float16) != sizeof(uint16_t)"
+    );
+    using uchar = unsigned char; // sizeof(unsigned char) is one byte
+
+    uint16_t xi{0};
+    auto const* i = reinterpret_cast<uchar const*>(&x);
+    std::copy(i, i + 2, reinterpret_cast<uchar*>(&xi));
+
+    return xi;
+}
+
+inline int
+FloatExp(uint16_t xi)
+{
+    // ignore sign bit
+    auto uxi = xi & 0x7fffu;
+
+    // inf, nan
+    if (uxi >= 0x7c00u)
+        return 0;
+
+    // ignore significand, zero shares the exponent of subnormal numbers
+    uxi = uxi >> 10;
+
+    int exp = (uxi == 0) ? -14 : static_cast<int>(uxi) - 15;
+    return exp;
+}
+#endif
+
 inline int
 FloatExp(uint32_t xi)
 {
     // ignore sign bit
     auto uxi = xi & 0x7fffffffu;
 
-    // 0, inf, nan
-    if (uxi == 0 || uxi >= 0x7f800000u)
+    // inf, nan
+    if (uxi >= 0x7f800000u)
         return 0;
 
-    // ignore significand
+    // ignore significand, zero shares the exponent of subnormal numbers
     uxi = uxi >> 23;
 
     int exp = (uxi == 0) ? -126 : static_cast<int>(uxi) - 127;
@@ -89,11 +132,11 @@ FloatExp(uint64_t xi)
     // ignore sign bit
     auto uxi = xi & 0x7fffffffffffffffll;
 
-    // 0, inf, nan
-    if (uxi == 0 || uxi >= 0x7ff0000000000000ll)
+    // inf, nan
+    if (uxi >= 0x7ff0000000000000ll)
         return 0;
 
-    // ignore significand
+    // ignore significand, zero shares the exponent of subnormal numbers
     uxi = uxi >> 52;
 
     int exp = (uxi == 0) ? -1022 : static_cast<int>(uxi) - 1023;
@@ -112,6 +155,37 @@ FloatSig(uint64_t xi) -> decltype(xi)
     return xi & 0x000fffffffffffffll;
 }
 
+#if defined(ZORDER_KNN_FLOAT16)
+inline auto
+FloatSig(uint16_t xi) -> decltype(xi)
+{
+    return static_cast<uint16_t>(xi & 0x03ffu);
+}
+#endif
+
+// Significand including the implicit leading bit of normal numbers.
+#if defined(ZORDER_KNN_FLOAT16)
+inline auto
+FloatFullSig(uint16_t xi) -> decltype(xi)
+{
+    return (xi & 0x7c00u) ? static_cast<uint16_t>(FloatSig(xi) | 0x0400u)
+                          : FloatSig(xi);
+}
+#endif
+
+inline auto
+FloatFullSig(uint32_t xi) -> decltype(xi)
+{
+    return (xi & 0x7f800000u) ? FloatSig(xi) | 0x00800000u : FloatSig(xi);
+}
+
+inline auto
+FloatFullSig(uint64_t xi) -> decltype(xi)
+{
+    return (xi & 0x7ff0000000000000ll) ? FloatSig(xi) | 0x0010000000000000ll
+                                       : FloatSig(xi);
+}
+
 constexpr auto log0_nan = std::numeric_limits<int8_t>::min();
 
 static constexpr
@@ -158,6 +232,12 @@ UIntLogBase2(uint32_t x) -> decltype(log0_nan)
     return log_base2;
 }
 
+inline int8_t
+UIntLogBase2(uint16_t x)
+{
+    return UIntLogBase2(static_cast<uint32_t>(x));
+}
+
 inline auto
 UIntLogBase2(uint64_t x) -> decltype(log0_nan)
 {
@@ -168,9 +248,50 @@ UIntLogBase2(uint64_t x) -> decltype(log0_nan)
     return log_base2;
 }
 
+// Index of the most significant set bit using the hardware leading zero
+// count, x must not be zero.
+inline int
+UIntClzLogBase2(uint32_t x)
+{
+    assert(x > 0);
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse(&i, x);
+    return static_cast<int>(i);
+#else
+    return 31 - __builtin_clz(x);
+#endif
+}
+
+inline int
+UIntClzLogBase2(uint16_t x)
+{
+    return UIntClzLogBase2(static_cast<uint32_t>(x));
+}
+
+inline int
+UIntClzLogBase2(uint64_t x)
+{
+    assert(x > 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return static_cast<int>(i);
+#elif defined(_MSC_VER)
+    auto x32 = static_cast<uint32_t>(x >> 32);
+    return (x32) ? UIntClzLogBase2(x32) + 32
+                 : UIntClzLogBase2(static_cast<uint32_t>(x));
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
 template <typename T> struct significand;
 template <> struct significand<float>  { static constexpr uint8_t nbits = 23; };
 template <> struct significand<double> { static constexpr uint8_t nbits = 52; };
+#if defined(ZORDER_KNN_FLOAT16)
+template <> struct significand<_Float16> { static constexpr uint8_t nbits = 10; };
+#endif
 
 template <typename Scalar>
 inline auto
@@ -186,7 +307,10 @@ FloatXorMsb(Scalar p, Scalar q) -> decltype(FloatExp(FloatToUInt(p)))
 
     if (p_exp == q_exp)
     {
-        auto xor_psig_qsig = FloatSig(pui) ^ FloatSig(qui);
+        // the smallest normal numbers differ from subnormal numbers in
+        // the implicit leading bit
+        auto xor_psig_qsig = static_cast<decltype(pui)>(
+            FloatFullSig(pui) ^ FloatFullSig(qui));
 
         if (xor_psig_qsig > 0)
             return p_exp + UIntLogBase2(xor_psig_qsig) - significand<Scalar>::nbits;
@@ -197,18 +321,222 @@ FloatXorMsb(Scalar p, Scalar q) -> decltype(FloatExp(FloatToUInt(p)))
     return std::max(p_exp, q_exp);
 }
 
+// FloatXorMsb computed on the bit patterns of p and q with conditional
+// moves in place of branches and a hardware leading zero count in place
+// of the table lookup. Yields the same result unless p or q is nan.
+template <typename Scalar>
+inline auto
+FloatXorMsbClz(Scalar p, Scalar q) -> decltype(FloatExp(FloatToUInt(p)))
+{
+    using UInt = decltype(FloatToUInt(p));
+    constexpr int nbits = significand<Scalar>::nbits;
+    constexpr int bias = std::numeric_limits<Scalar>::max_exponent - 1;
+    constexpr int e_inf = 2 * bias + 1;
+    constexpr UInt abs_mask = ~UInt(0) >> 1;
+    constexpr UInt sig_mask = (UInt(1) << nbits) - 1;
+
+    auto pa = FloatToUInt(p) & abs_mask;
+    auto qa = FloatToUInt(q) & abs_mask;
+
+    auto pe = static_cast<int>(pa >> nbits);
+    auto qe = static_cast<int>(qa >> nbits);
+
+    // zero shares the exponent of subnormal numbers, inf and nan map to 0
+    auto p_exp = (pe == e_inf) ? 0 : std::max(pe, 1) - bias;
+    auto q_exp = (qe == e_inf) ? 0 : std::max(qe, 1) - bias;
+
+    auto p_sig = (pa & sig_mask) | (UInt(pe != 0) << nbits);
+    auto q_sig = (qa & sig_mask) | (UInt(qe != 0) << nbits);
+    auto xor_sig = p_sig ^ q_sig;
+
+    // or-ing in the lowest bit keeps the leading zero count defined
+    auto y_eq = p_exp + UIntClzLogBase2(xor_sig | 1) - nbits;
+    y_eq = (xor_sig != 0) ? y_eq : p_exp;
+
+    auto y = (p_exp == q_exp) ? y_eq : std::max(p_exp, q_exp);
+    return (pa == qa) ? std::numeric_limits<int>::min() : y;
+}
+
+#if defined(ZORDER_KNN_FLOAT16)
+// The half precision numbers are exact in single precision.
+inline int
+FloatXorMsbClz(_Float16 p, _Float16 q)
+{
+    return FloatXorMsbClz(static_cast<float>(p), static_cast<float>(q));
+}
+#endif
+
+// Brain floating point numbers share the exponent of float and are exact
+// in single precision.
+inline int
+FloatXorMsb(BFloat16 p, BFloat16 q)
+{
+    return FloatXorMsb(static_cast<float>(p), static_cast<float>(q));
+}
+
+inline int
+FloatXorMsbClz(BFloat16 p, BFloat16 q)
+{
+    return FloatXorMsbClz(static_cast<float>(p), static_cast<float>(q));
+}
+
+// Integer coordinates are fixed point numbers with the bits of their
+// magnitude at positions 0 and above, as those of float and double.
+template <typename Int>
+using IntMagnitude = typename std::conditional<sizeof(Int) <= 4, uint32_t,
+    uint64_t>::type;
+
+template <typename Int>
+inline IntMagnitude<Int>
+IntAbs(Int x, std::true_type /* is_signed */)
+{
+    using UInt = IntMagnitude<Int>;
+    return (x < 0) ? UInt(0) - static_cast<UInt>(x) : static_cast<UInt>(x);
+}
+
+template <typename Int>
+inline IntMagnitude<Int>
+IntAbs(Int x, std::false_type /* is_signed */)
+{
+    return static_cast<IntMagnitude<Int>>(x);
+}
+
+template <typename Int>
+inline IntMagnitude<Int>
+IntAbs(Int x)
+{
+    return IntAbs(x, std::is_signed<Int>());
+}
+
+template <typename Int, typename std::enable_if<
+    std::is_integral<Int>::value, int>::type = 0>
+inline int
+FloatXorMsb(Int p, Int q)
+{
+    auto x = IntAbs(p) ^ IntAbs(q);
+    return x ? UIntLogBase2(x) : std::numeric_limits<int>::min();
+}
+
+template <typename Int, typename std::enable_if<
+    std::is_integral<Int>::value, int>::type = 0>
+inline int
+FloatXorMsbClz(Int p, Int q)
+{
+    auto x = IntAbs(p) ^ IntAbs(q);
+    return x ? UIntClzLogBase2(x) : std::numeric_limits<int>::min();
+}
+
+// The exponent of x bounds FloatXorMsb(x, y) from above for all y of the
+// same sign.
+template <typename Scalar>
+inline auto
+CoordinateExp(Scalar x) -> decltype(FloatExp(FloatToUInt(x)))
+{
+    return FloatExp(FloatToUInt(x));
+}
+
+inline int
+CoordinateExp(BFloat16 x)
+{
+    return CoordinateExp(static_cast<float>(x));
+}
+
+template <typename Int, typename std::enable_if<
+    std::is_integral<Int>::value, int>::type = 0>
+inline int
+CoordinateExp(Int x)
+{
+    auto a = IntAbs(x);
+    return a ? UIntLogBase2(a) : std::numeric_limits<int>::min();
+}
+
+// |p| == |q|, i.e. FloatXorMsb(p, q) finds no differing bit.
+template <typename Scalar>
+inline auto
+AbsEqual(Scalar p, Scalar q) -> decltype(FloatToUInt(p), bool())
+{
+    return p == q || p == -q;
+}
+
+template <typename Int, typename std::enable_if<
+    std::is_integral<Int>::value, int>::type = 0>
+inline bool
+AbsEqual(Int p, Int q)
+{
+    return IntAbs(p) == IntAbs(q);
+}
+
+// x < 0, false for -0.0 and unsigned integers.
+template <typename Scalar>
+inline bool
+IsNegative(Scalar x, std::false_type /* is_unsigned */)
+{
+    return x < Scalar(0);
+}
+
+template <typename Scalar>
+inline bool
+IsNegative(Scalar, std::true_type /* is_unsigned */)
+{
+    return false;
+}
+
+template <typename Scalar>
+inline bool
+IsNegative(Scalar x)
+{
+    return IsNegative(x, std::is_unsigned<Scalar>());
+}
+
 } // namespace detail
 
+// Policies computing the most significant bit in which two floating point
+// numbers differ for Less.
+
+// Lookup table based, see detail::FloatXorMsb().
+struct XorMsbTable
+{
+    template <typename Scalar>
+    int operator()(Scalar p, Scalar q) const
+    {
+        return detail::FloatXorMsb(p, q);
+    }
+};
+
+// Leading zero count based, see detail::FloatXorMsbClz().
+struct XorMsbClz
+{
+    template <typename Scalar>
+    int operator()(Scalar p, Scalar q) const
+    {
+        return detail::FloatXorMsbClz(p, q);
+    }
+};
+
+// Policy of Less which records no statistics, see stats.hpp for a
+// counting policy.
+struct NoStats
+{
+    static void Compare() {}
+    static void SignMismatch(std::size_t) {}
+    template <typename Scalar>
+    static void Coordinate(Scalar, Scalar) {}
+    static void Decided(std::size_t, bool) {}
+};
+
 // The relative z-order of two points is determined by the pair of
 // coordinates who have the first differing bit with the highest
-// exponent.
-template <typename Point, std::size_t d>
+// exponent. The XorMsb policy computes the exponent of that bit, the
+// Stats policy is notified of the branches taken. Coordinates are float,
+// double, _Float16, BFloat16 or integers, where integers are ordered as
+// the floating point numbers of the same values.
+template <typename Point, std::size_t d, typename XorMsb = XorMsbTable,
+    typename Stats = NoStats>
 struct Less
 {
     bool operator()(Point const& p, Point const& q) const
     {
-        using Scalar = decltype(p[0]);
-        constexpr auto zero = Scalar(0.0);
+        Stats::Compare();
 
         auto x = std::numeric_limits<int>::min();
         std::size_t k{0};
@@ -216,10 +544,14 @@ struct Less
         // Starting from j = 0 generates a N- instead of a Z-curve.
         for (std::size_t j{d}; j-- > 0;)
         {
-            if ((p[j] < zero) != (q[j] < zero))
+            if (detail::IsNegative(p[j]) != detail::IsNegative(q[j]))
+            {
+                Stats::SignMismatch(j);
                 return p[j] < q[j];
+            }
 
-            auto y = detail::FloatXorMsb(p[j], q[j]);
+            Stats::Coordinate(p[j], q[j]);
+            auto y = XorMsb()(p[j], q[j]);
 
             if (x < y)
             {
@@ -228,6 +560,7 @@ struct Less
             }
         }
 
+        Stats::Decided(k, x == std::numeric_limits<int>::min());
         return p[k] < q[k];
     }
 };
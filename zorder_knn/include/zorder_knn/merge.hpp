@@ -0,0 +1,168 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_MERGE_HPP
+#define ZORDER_KNN_MERGE_HPP
+
+#include "less.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Tournament tree of losers selecting the smallest head among k sources,
+// where before(a, b) compares the heads of the sources a and b. Ties are
+// broken by the index of the source. Replacing the head of the winner
+// takes a single path of log2(k) comparisons from its leaf to the root,
+// about half as many as sifting down a binary heap.
+template <typename Before>
+class LoserTree
+{
+public:
+    // Sources for which done(i) holds are exhausted from the start.
+    template <typename Done>
+    LoserTree(std::size_t k, Before before, Done done)
+        : k_{k}, before_(before), done_(k), losers_(k)
+    {
+        for (std::size_t i{0}; i < k_; ++i) { done_[i] = done(i); }
+        if (k_ == 0) return;
+
+        // winners of the subtrees, leaf i is node k + i
+        std::vector<std::size_t> winners(2 * k_);
+        for (std::size_t i{0}; i < k_; ++i) { winners[k_ + i] = i; }
+        for (auto node = k_; node-- > 1;)
+        {
+            auto a = winners[2 * node], b = winners[2 * node + 1];
+            if (Beats(a, b))
+            {
+                winners[node] = a;
+                losers_[node] = b;
+            }
+            else
+            {
+                winners[node] = b;
+                losers_[node] = a;
+            }
+        }
+        winner_ = k_ > 1 ? winners[1] : 0;
+    }
+
+    bool Empty() const { return k_ == 0 || done_[winner_]; }
+
+    // Source holding the smallest head.
+    std::size_t Top() const { return winner_; }
+
+    // Replay the tournament after the head of Top() advanced, done tells
+    // whether the source is exhausted now.
+    void Replay(bool done)
+    {
+        auto w = winner_;
+        done_[w] = done;
+        for (auto node = (k_ + w) / 2; node > 0; node /= 2)
+        {
+            if (Beats(losers_[node], w)) std::swap(losers_[node], w);
+        }
+        winner_ = w;
+    }
+
+private:
+    bool Beats(std::size_t a, std::size_t b) const
+    {
+        if (done_[a] || done_[b]) return !done_[a];
+        return before_(a, b) || (a < b && !before_(b, a));
+    }
+
+    std::size_t k_;
+    Before before_;
+    std::vector<char> done_;
+    std::vector<std::size_t> losers_;
+    std::size_t winner_ = 0;
+};
+
+template <typename Before, typename Done>
+LoserTree<Before>
+MakeLoserTree(std::size_t k, Before before, Done done)
+{
+    return LoserTree<Before>(k, before, done);
+}
+
+} // namespace detail
+
+// Merge the z-sorted ranges [ranges[i].first, ranges[i].second) into out
+// with a loser tree ordered by Less. Equal points are output in the order
+// of their ranges, hence the merge is stable. Returns the end of the
+// output.
+template <typename Point, std::size_t d, typename ForwardIt,
+    typename OutputIt>
+OutputIt
+MergeSorted(std::vector<std::pair<ForwardIt, ForwardIt>> ranges,
+    OutputIt out)
+{
+    Less<Point, d> less;
+    auto tree = detail::MakeLoserTree(ranges.size(),
+        [&](std::size_t a, std::size_t b) {
+            return less(*ranges[a].first, *ranges[b].first);
+        },
+        [&](std::size_t i) { return ranges[i].first == ranges[i].second; });
+
+    while (!tree.Empty())
+    {
+        auto& range = ranges[tree.Top()];
+        *out++ = *range.first++;
+        tree.Replay(range.first == range.second);
+    }
+
+    return out;
+}
+
+template <typename Point, std::size_t d>
+std::vector<Point>
+MergeSorted(std::vector<std::vector<Point>> const& runs)
+{
+    using Iterator = typename std::vector<Point>::const_iterator;
+
+    std::size_t n{0};
+    std::vector<std::pair<Iterator, Iterator>> ranges;
+    for (auto const& run : runs)
+    {
+        ranges.emplace_back(run.begin(), run.end());
+        n += run.size();
+    }
+
+    std::vector<Point> merged;
+    merged.reserve(n);
+    MergeSorted<Point, d>(std::move(ranges), std::back_inserter(merged));
+
+    return merged;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_MERGE_HPP
@@ -0,0 +1,94 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_PARALLEL_KNN_HPP
+#define ZORDER_KNN_PARALLEL_KNN_HPP
+
+#include "knn.hpp"
+#include "parallel_sort.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+// Build the exact k-nearest neighbor graph as BuildKnnGraph() does, using
+// the threads of the pool. The points are sorted by ParallelSort() and
+// the sorted array is split into chunks of chunk_size consecutive points,
+// each one a task of the pool, so idle threads steal the chunks of busy
+// ones. The candidate windows of the first and last k points of a chunk
+// read a halo of k points of the neighboring chunks, and refining the
+// candidates may search the whole array, which all chunks share
+// read-only.
+//
+// Every row of the graph depends on the sorted points only, hence the
+// result is identical to the one of BuildKnnGraph() for any number of
+// threads and any chunk size. Throws std::invalid_argument unless k < n
+// or k == 0.
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+ParallelBuildKnnGraph(ThreadPool& pool, std::vector<Point> const& points,
+    std::size_t k, std::size_t chunk_size = 4096)
+{
+    auto n = points.size();
+    if (k == 0) return {};
+    if (k >= n) throw std::invalid_argument("k >= number of points");
+
+    auto perm = detail::ParallelSortPermutation<Point, d>(pool,
+        points.begin(), points.end());
+
+    std::vector<Point> sorted(n);
+    ParallelFor(pool, n, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) { sorted[i] = points[perm[i]]; }
+    });
+
+    std::vector<std::size_t> graph(n * k);
+    chunk_size = std::max(chunk_size, std::size_t(1));
+    for (std::size_t begin{0}; begin < n; begin += chunk_size)
+    {
+        auto end = std::min(begin + chunk_size, n);
+        pool.Submit([&, begin, end] {
+            detail::KnnGraphRows<Point, d>(sorted, perm, k, begin, end,
+                graph.data());
+        });
+    }
+
+    pool.Wait();
+    return graph;
+}
+
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+ParallelBuildKnnGraph(std::vector<Point> const& points, std::size_t k,
+    std::size_t nthreads = DefaultNumThreads())
+{
+    ThreadPool pool(nthreads);
+    return ParallelBuildKnnGraph<Point, d>(pool, points, k);
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_PARALLEL_KNN_HPP
@@ -0,0 +1,286 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_PARALLEL_SORT_HPP
+#define ZORDER_KNN_PARALLEL_SORT_HPP
+
+#include "sort.hpp"
+#include "thread_pool.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <numeric>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+inline void
+InsertionSortKeys(uint64_t* keys, std::size_t* perm, uint64_t* key_tmp,
+    std::size_t begin, std::size_t end, std::size_t nwords)
+{
+    for (std::size_t i{begin + 1}; i < end; ++i)
+    {
+        std::copy(keys + i * nwords, keys + (i + 1) * nwords, key_tmp);
+        auto pi = perm[i];
+
+        auto j = i;
+        for (; j > begin && KeyLess(key_tmp, keys + (j - 1) * nwords, nwords); --j)
+        {
+            std::copy(keys + (j - 1) * nwords, keys + j * nwords, keys + j * nwords);
+            perm[j] = perm[j - 1];
+        }
+
+        std::copy(key_tmp, key_tmp + nwords, keys + j * nwords);
+        perm[j] = pi;
+    }
+}
+
+// Stable MSD radix sort of the keys in [begin, end) by their digits
+// [0, ndigits). Buckets of at least task_size keys are sorted by separate
+// tasks. The temporary arrays must provide the same index range.
+inline void
+MsdRadixSortKeys(ThreadPool& pool,
+    uint64_t* keys, std::size_t* perm,
+    uint64_t* keys_tmp, std::size_t* perm_tmp,
+    std::size_t begin, std::size_t end,
+    std::size_t nwords, std::size_t ndigits)
+{
+    constexpr std::size_t insertion_sort_size = 32;
+    constexpr std::size_t task_size = std::size_t(1) << 14;
+
+    auto n = end - begin;
+    while (ndigits > 0 && n > insertion_sort_size)
+    {
+        auto t = --ndigits;
+
+        std::size_t count[256] = {};
+        for (auto i = begin; i < end; ++i)
+        {
+            ++count[KeyDigit(keys + i * nwords, nwords, t)];
+        }
+
+        if (std::any_of(count, count + 256,
+            [n](std::size_t c) { return c == n; }))
+        {
+            continue;
+        }
+
+        std::size_t bucket[257];
+        bucket[0] = begin;
+        for (std::size_t b{0}; b < 256; ++b) { bucket[b + 1] = bucket[b] + count[b]; }
+
+        std::size_t offset[256];
+        std::copy(bucket, bucket + 256, offset);
+
+        for (auto i = begin; i < end; ++i)
+        {
+            auto i1 = offset[KeyDigit(keys + i * nwords, nwords, t)]++;
+            std::copy(keys + i * nwords, keys + (i + 1) * nwords,
+                keys_tmp + i1 * nwords);
+            perm_tmp[i1] = perm[i];
+        }
+
+        std::copy(keys_tmp + begin * nwords, keys_tmp + end * nwords,
+            keys + begin * nwords);
+        std::copy(perm_tmp + begin, perm_tmp + end, perm + begin);
+
+        for (std::size_t b{0}; b < 256; ++b)
+        {
+            auto b0 = bucket[b], b1 = bucket[b + 1];
+            if (b1 - b0 <= 1) continue;
+
+            if (b1 - b0 >= task_size)
+            {
+                pool.Submit([=, &pool] {
+                    MsdRadixSortKeys(pool, keys, perm, keys_tmp, perm_tmp,
+                        b0, b1, nwords, ndigits);
+                });
+            }
+            else
+            {
+                MsdRadixSortKeys(pool, keys, perm, keys_tmp, perm_tmp,
+                    b0, b1, nwords, ndigits);
+            }
+        }
+
+        return;
+    }
+
+    InsertionSortKeys(keys, perm, keys_tmp + begin * nwords, begin, end,
+        nwords);
+}
+
+// Sort keys as RadixSortKeys() does. The most significant digit which
+// differs between the keys is partitioned in parallel, the resulting
+// buckets are sorted by MsdRadixSortKeys().
+inline void
+ParallelRadixSortKeys(ThreadPool& pool,
+    std::vector<uint64_t>& keys, std::vector<std::size_t>& perm,
+    std::size_t nwords, std::size_t nbits)
+{
+    auto n = perm.size();
+    auto nchunks = std::min(n, 4 * pool.NumThreads());
+    auto chunk = [n, nchunks](std::size_t c) {
+        return std::make_pair(n * c / nchunks, n * (c + 1) / nchunks);
+    };
+
+    std::vector<uint64_t> keys_tmp(keys.size());
+    std::vector<std::size_t> perm_tmp(n);
+
+    for (auto t = (nbits + 7) / 8; t-- > 0;)
+    {
+        std::vector<std::size_t> counts(nchunks * 256, 0);
+        ParallelFor(pool, nchunks, [&](std::size_t cb, std::size_t ce) {
+            for (auto c = cb; c < ce; ++c)
+            {
+                auto* count = counts.data() + c * 256;
+                for (auto i = chunk(c).first; i < chunk(c).second; ++i)
+                {
+                    ++count[KeyDigit(keys.data() + i * nwords, nwords, t)];
+                }
+            }
+        });
+
+        // offsets of the buckets per chunk
+        std::size_t offset{0};
+        std::vector<std::size_t> buckets(257, 0);
+        for (std::size_t b{0}; b < 256; ++b)
+        {
+            buckets[b] = offset;
+            for (std::size_t c{0}; c < nchunks; ++c)
+            {
+                auto count = counts[c * 256 + b];
+                counts[c * 256 + b] = offset;
+                offset += count;
+            }
+        }
+        buckets[256] = n;
+
+        std::size_t b{0};
+        while (b < 256 && buckets[b + 1] - buckets[b] < n) { ++b; }
+        if (b < 256) continue;
+
+        ParallelFor(pool, nchunks, [&](std::size_t cb, std::size_t ce) {
+            for (auto c = cb; c < ce; ++c)
+            {
+                auto* offset = counts.data() + c * 256;
+                for (auto i = chunk(c).first; i < chunk(c).second; ++i)
+                {
+                    auto const* key = keys.data() + i * nwords;
+                    auto i1 = offset[KeyDigit(key, nwords, t)]++;
+                    std::copy(key, key + nwords, keys_tmp.data() + i1 * nwords);
+                    perm_tmp[i1] = perm[i];
+                }
+            }
+        });
+
+        keys.swap(keys_tmp);
+        perm.swap(perm_tmp);
+
+        for (b = 0; b < 256; ++b)
+        {
+            auto begin = buckets[b], end = buckets[b + 1];
+            if (end - begin <= 1) continue;
+
+            pool.Submit([&, begin, end, t] {
+                MsdRadixSortKeys(pool, keys.data(), perm.data(),
+                    keys_tmp.data(), perm_tmp.data(), begin, end, nwords, t);
+            });
+        }
+
+        pool.Wait();
+        return;
+    }
+}
+
+template <typename Point, std::size_t d, typename RandomIt>
+std::vector<std::size_t>
+ParallelSortPermutation(ThreadPool& pool, RandomIt first, RandomIt last)
+{
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+
+    std::vector<KeyBitRange> ranges(pool.NumThreads() * 4);
+    ParallelFor(pool, ranges.size(), [&](std::size_t cb, std::size_t ce) {
+        for (auto c = cb; c < ce; ++c)
+        {
+            ranges[c] = MakeKeyBitRange<Point, d>(
+                first + n * c / ranges.size(),
+                first + n * (c + 1) / ranges.size());
+        }
+    });
+
+    KeyBitRange range;
+    for (auto const& r : ranges) { range.Merge(r); }
+    auto layout = MakeKeyLayout<d>(range);
+
+    std::vector<uint64_t> keys(n * layout.nwords);
+    std::vector<std::size_t> perm(n);
+    ParallelFor(pool, n, [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i)
+        {
+            MakeKey<Point, d>(layout, first[i], keys.data() + i * layout.nwords);
+            perm[i] = i;
+        }
+    });
+
+    ParallelRadixSortKeys(pool, keys, perm, layout.nwords, layout.nbits);
+    return perm;
+}
+
+} // namespace detail
+
+// Sort points in z-order using the threads of the pool. The result is
+// identical to the one of Sort().
+template <typename Point, std::size_t d, typename RandomIt>
+void
+ParallelSort(ThreadPool& pool, RandomIt first, RandomIt last)
+{
+    auto perm = detail::ParallelSortPermutation<Point, d>(pool, first, last);
+
+    std::vector<Point> sorted(perm.size());
+    ParallelFor(pool, perm.size(), [&](std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) { sorted[i] = std::move(first[perm[i]]); }
+    });
+    ParallelFor(pool, perm.size(), [&](std::size_t begin, std::size_t end) {
+        std::move(sorted.begin() + begin, sorted.begin() + end, first + begin);
+    });
+}
+
+template <typename Point, std::size_t d, typename RandomIt>
+void
+ParallelSort(RandomIt first, RandomIt last,
+    std::size_t nthreads = DefaultNumThreads())
+{
+    ThreadPool pool(nthreads);
+    ParallelSort<Point, d>(pool, first, last);
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_PARALLEL_SORT_HPP
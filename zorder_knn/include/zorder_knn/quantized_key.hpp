@@ -0,0 +1,308 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_QUANTIZED_KEY_HPP
+#define ZORDER_KNN_QUANTIZED_KEY_HPP
+
+#include "box.hpp"
+#include "key.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <type_traits>
+
+// Bits are interleaved with shifts and masks by default. Batches of keys
+// vectorize well that way, and on many machines this is faster than the
+// scalar BMI2 instructions pdep and pext, which are also slow on AMD
+// processors before Zen 3. Define ZORDER_KNN_USE_PDEP to use pdep and pext
+// if the compiler targets them, e.g. with -mbmi2 or -march=native.
+#if defined(ZORDER_KNN_USE_PDEP) && !defined(ZORDER_KNN_NO_SIMD)
+#if defined(__BMI2__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define ZORDER_KNN_BMI2
+#include <immintrin.h>
+#endif
+#endif
+
+namespace zorder_knn
+{
+
+// Morton key of 128 bits, compared as hi first.
+struct QuantizedKey128
+{
+    uint64_t hi, lo;
+
+    friend bool operator<(QuantizedKey128 const& a, QuantizedKey128 const& b)
+    {
+        return a.hi < b.hi || (a.hi == b.hi && a.lo < b.lo);
+    }
+
+    friend bool operator==(QuantizedKey128 const& a, QuantizedKey128 const& b)
+    {
+        return a.hi == b.hi && a.lo == b.lo;
+    }
+};
+
+namespace detail
+{
+
+// Mask of bit positions i * d + j of a 64-bit word.
+template <std::size_t d>
+constexpr uint64_t
+MortonMask(std::size_t j, std::size_t i = 0)
+{
+    return i * d + j >= 64 ? 0
+        : (uint64_t(1) << (i * d + j)) | MortonMask<d>(j, i + 1);
+}
+
+// Move bit i of x to bit i * d, for the lowest 64 / d bits of x.
+inline uint64_t
+MortonSpread(uint64_t x, std::integral_constant<std::size_t, 2>)
+{
+    x &= 0x00000000ffffffffull;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+inline uint64_t
+MortonSpread(uint64_t x, std::integral_constant<std::size_t, 3>)
+{
+    x &= 0x00000000001fffffull;
+    x = (x | (x << 32)) & 0x001f00000000ffffull;
+    x = (x | (x << 16)) & 0x001f0000ff0000ffull;
+    x = (x | (x << 8)) & 0x100f00f00f00f00full;
+    x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+    x = (x | (x << 2)) & 0x1249249249249249ull;
+    return x;
+}
+
+template <std::size_t d>
+inline uint64_t
+MortonSpread(uint64_t x, std::integral_constant<std::size_t, d>)
+{
+    uint64_t r{0};
+    for (std::size_t i{0}; i < 64 / d; ++i) { r |= ((x >> i) & 1) << (i * d); }
+
+    return r;
+}
+
+// Inverse of MortonSpread(), bits other than i * d of x are ignored.
+inline uint64_t
+MortonCompact(uint64_t x, std::integral_constant<std::size_t, 2>)
+{
+    x &= 0x5555555555555555ull;
+    x = (x | (x >> 1)) & 0x3333333333333333ull;
+    x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0full;
+    x = (x | (x >> 4)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x >> 8)) & 0x0000ffff0000ffffull;
+    x = (x | (x >> 16)) & 0x00000000ffffffffull;
+    return x;
+}
+
+inline uint64_t
+MortonCompact(uint64_t x, std::integral_constant<std::size_t, 3>)
+{
+    x &= 0x1249249249249249ull;
+    x = (x | (x >> 2)) & 0x10c30c30c30c30c3ull;
+    x = (x | (x >> 4)) & 0x100f00f00f00f00full;
+    x = (x | (x >> 8)) & 0x001f0000ff0000ffull;
+    x = (x | (x >> 16)) & 0x001f00000000ffffull;
+    x = (x | (x >> 32)) & 0x00000000001fffffull;
+    return x;
+}
+
+template <std::size_t d>
+inline uint64_t
+MortonCompact(uint64_t x, std::integral_constant<std::size_t, d>)
+{
+    uint64_t r{0};
+    for (std::size_t i{0}; i < 64 / d; ++i) { r |= ((x >> (i * d)) & 1) << i; }
+
+    return r;
+}
+
+// Interleave the lowest 64 / d bits of the coordinates q, bit i of q[j]
+// becomes bit i * d + j of the key.
+template <std::size_t d>
+inline uint64_t
+MortonInterleave(uint64_t const* q)
+{
+    uint64_t key{0};
+    for (std::size_t j{0}; j < d; ++j)
+    {
+#if defined(ZORDER_KNN_BMI2)
+        key |= _pdep_u64(q[j], MortonMask<d>(j));
+#else
+        key |= MortonSpread(q[j], std::integral_constant<std::size_t, d>()) << j;
+#endif
+    }
+
+    return key;
+}
+
+template <std::size_t d>
+inline void
+MortonDeinterleave(uint64_t key, uint64_t* q)
+{
+    for (std::size_t j{0}; j < d; ++j)
+    {
+#if defined(ZORDER_KNN_BMI2)
+        q[j] = _pext_u64(key, MortonMask<d>(j));
+#else
+        q[j] = MortonCompact(key >> j, std::integral_constant<std::size_t, d>());
+#endif
+    }
+}
+
+} // namespace detail
+
+// Morton keys of points quantized to a grid of 2^bits cells per axis
+// within a bounding box. A key of type uint64_t holds up to 64 / d bits
+// per axis and a QuantizedKey128 twice as many.
+//
+// Keys interleave the bits of the quantized coordinates with axis d - 1
+// most significant, as Less does. If the box is the cube [0, 2^e]^d, the
+// grid cells are cells of the z-order of Less and the order of the keys of
+// points within [0, 2^e)^d is that of Less, except that points in the same
+// grid cell share a key. For other boxes the orders differ.
+template <typename Point, std::size_t d, typename Key = uint64_t>
+class QuantizedKeyCoder
+{
+public:
+    // The 128-bit key holds 64 / d bits per axis in each word, which for
+    // some d is less than 128 / d.
+    static constexpr unsigned max_bits = static_cast<unsigned>(
+        (std::is_same<Key, QuantizedKey128>::value ? 2 : 1) * (64 / d));
+
+    static_assert(std::is_same<Key, uint64_t>::value ||
+        std::is_same<Key, QuantizedKey128>::value,
+        "Key must be uint64_t or QuantizedKey128");
+    static_assert(d >= 2 && max_bits > 0, "d must be within [2, 64]");
+
+    // Coordinates outside the box are clamped to it.
+    explicit QuantizedKeyCoder(Box<Point> const& box, unsigned bits = max_bits)
+        : bits_{std::max(1u, std::min(bits, max_bits))}
+    {
+        auto ncells = static_cast<double>(uint64_t(1) << (bits_ - 1)) * 2.0;
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            auto extent = static_cast<double>(box.hi[j]) - static_cast<double>(box.lo[j]);
+
+            lo_[j] = static_cast<double>(box.lo[j]);
+            scale_[j] = extent > 0.0 ? ncells / extent : 0.0;
+            inv_scale_[j] = extent / ncells;
+        }
+    }
+
+    unsigned Bits() const { return bits_; }
+
+    Key Encode(Point const& p) const
+    {
+        uint64_t q[d];
+        Quantize(p, q);
+        return Interleave(q, Key());
+    }
+
+    template <typename InputIt, typename OutputIt>
+    OutputIt Encode(InputIt first, InputIt last, OutputIt out) const
+    {
+        for (; first != last; ++first, ++out) { *out = Encode(*first); }
+
+        return out;
+    }
+
+    // Center of the grid cell of the key.
+    Point Decode(Key const& key) const
+    {
+        uint64_t q[d];
+        Deinterleave(key, q);
+
+        Point p;
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            p[j] = static_cast<detail::PointScalar<Point>>(
+                lo_[j] + (static_cast<double>(q[j]) + 0.5) * inv_scale_[j]);
+        }
+
+        return p;
+    }
+
+    // Grid cell of p per axis.
+    void Quantize(Point const& p, uint64_t* q) const
+    {
+        auto q_max = ~uint64_t(0) >> (64 - bits_);
+        auto x_max = static_cast<double>(q_max);
+
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            auto x = (static_cast<double>(p[j]) - lo_[j]) * scale_[j];
+            q[j] = x > 0.0 ? (x < x_max ? static_cast<uint64_t>(x) : q_max) : 0;
+        }
+    }
+
+private:
+    // The 128-bit key interleaves the upper bits of the coordinates in hi
+    // and the lower 64 / d bits in lo.
+    static constexpr unsigned lo_bits = 64 / d;
+
+    uint64_t Interleave(uint64_t const* q, uint64_t) const
+    {
+        return detail::MortonInterleave<d>(q);
+    }
+
+    QuantizedKey128 Interleave(uint64_t const* q, QuantizedKey128) const
+    {
+        uint64_t q_lo[d], q_hi[d];
+        for (std::size_t j{0}; j < d; ++j)
+        {
+            q_lo[j] = q[j] & ((uint64_t(1) << lo_bits) - 1);
+            q_hi[j] = q[j] >> lo_bits;
+        }
+
+        return { detail::MortonInterleave<d>(q_hi), detail::MortonInterleave<d>(q_lo) };
+    }
+
+    void Deinterleave(uint64_t key, uint64_t* q) const
+    {
+        detail::MortonDeinterleave<d>(key, q);
+    }
+
+    void Deinterleave(QuantizedKey128 const& key, uint64_t* q) const
+    {
+        uint64_t q_hi[d];
+        detail::MortonDeinterleave<d>(key.lo, q);
+        detail::MortonDeinterleave<d>(key.hi, q_hi);
+        for (std::size_t j{0}; j < d; ++j) { q[j] |= q_hi[j] << lo_bits; }
+    }
+
+    unsigned bits_;
+    std::array<double, d> lo_, scale_, inv_scale_;
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_QUANTIZED_KEY_HPP
@@ -0,0 +1,343 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_RADIX_TREE_HPP
+#define ZORDER_KNN_RADIX_TREE_HPP
+
+#include "knn.hpp"
+#include "box.hpp"
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+// Significance of the most significant bit of the z-order at which p and
+// q differ: the signs precede all magnitude bits, axis d - 1 the others
+// at the same bit position. Returns the minimum of int64_t if p and q are
+// equal and a value of at least zero otherwise.
+template <typename Point, std::size_t d>
+int64_t
+ZOrderDiffBit(Point const& p, Point const& q)
+{
+    using Scalar = PointScalar<Point>;
+    constexpr auto zero = Scalar(0.0);
+    constexpr int64_t nd = static_cast<int64_t>(d);
+
+    auto x = std::numeric_limits<int>::min();
+    std::size_t k{0};
+
+    for (std::size_t j{d}; j-- > 0;)
+    {
+        if ((p[j] < zero) != (q[j] < zero))
+        {
+            return (int64_t(1) << 40) + static_cast<int64_t>(j);
+        }
+
+        auto y = FloatXorMsb(p[j], q[j]);
+        if (x < y)
+        {
+            x = y;
+            k = j;
+        }
+    }
+
+    if (x == std::numeric_limits<int>::min())
+    {
+        return std::numeric_limits<int64_t>::min();
+    }
+
+    // bit positions range from the smallest subnormal to the largest
+    // exponent of double
+    return (static_cast<int64_t>(x) + 4096) * nd + static_cast<int64_t>(k);
+}
+
+} // namespace detail
+
+// Binary radix tree over points sorted in z-order by Less, following
+// Karras, built in O(n) without quantizing the coordinates. Internal node
+// i splits the leaves, i.e. the points, at the first bit of the z-order
+// in which they differ, found from the XOR-MSB of the floating point
+// coordinates as in Less. Ties between equal points are split by index.
+// Each of the n - 1 internal nodes is built independently of the others
+// and the bounding boxes are computed bottom-up, both in parallel.
+//
+// Nodes live in flat arrays: the two children of internal node i, where
+// a leaf is tagged by leaf_bit, and the bounding box of its points. The
+// root is internal node 0. The tree refers to the points, which must
+// outlive it and stay unchanged.
+template <typename Point, std::size_t d>
+class RadixTree
+{
+public:
+    using Scalar = detail::PointScalar<Point>;
+
+    static constexpr std::size_t leaf_bit =
+        std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 1);
+
+    RadixTree(ThreadPool& pool, std::vector<Point> const& sorted_points)
+        : points_(&sorted_points)
+    {
+        Build(pool);
+    }
+
+    explicit RadixTree(std::vector<Point> const& sorted_points,
+        std::size_t nthreads = DefaultNumThreads())
+        : points_(&sorted_points)
+    {
+        ThreadPool pool(nthreads);
+        Build(pool);
+    }
+
+    std::size_t Size() const { return points_->size(); }
+    std::size_t NumInternalNodes() const { return boxes_.size(); }
+
+    // Root node, a leaf if the tree holds a single point. Requires
+    // Size() > 0.
+    std::size_t Root() const { return boxes_.empty() ? leaf_bit : 0; }
+
+    std::size_t Left(std::size_t node) const { return children_[2 * node]; }
+    std::size_t Right(std::size_t node) const { return children_[2 * node + 1]; }
+    Box<Point> const& NodeBox(std::size_t node) const { return boxes_[node]; }
+
+    // Call f(i) for the indices of all points within distance r of p.
+    template <typename F>
+    void ForEachWithin(Point const& p, Scalar r, F f) const
+    {
+        if (Size() == 0 || r < Scalar(0)) return;
+        auto r2 = r * r;
+
+        std::vector<std::size_t> stack{ Root() };
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+
+            if (node & leaf_bit)
+            {
+                auto i = node & ~leaf_bit;
+                if (detail::SquaredDistance<Point, d>(p, (*points_)[i]) <= r2) f(i);
+            }
+            else if (detail::SquaredDistance<Point, d>(p, boxes_[node]) <= r2)
+            {
+                stack.push_back(Right(node));
+                stack.push_back(Left(node));
+            }
+        }
+    }
+
+    // Indices of all points within distance r of p in increasing order.
+    std::vector<std::size_t> FindWithin(Point const& p, Scalar r) const
+    {
+        std::vector<std::size_t> found;
+        ForEachWithin(p, r, [&found](std::size_t i) { found.push_back(i); });
+        std::sort(found.begin(), found.end());
+
+        return found;
+    }
+
+    // Indices of the min(k, n) nearest neighbors of p in order of
+    // increasing distance, ties broken by index, as FindKNearest().
+    std::vector<std::size_t> FindKNearest(Point const& p, std::size_t k) const
+    {
+        k = std::min(k, Size());
+        if (k == 0) return {};
+
+        detail::KnnHeap<Scalar> heap(k);
+
+        // descend into the closer child first
+        std::vector<std::pair<Scalar, std::size_t>> stack{ { Scalar(0), Root() } };
+        while (!stack.empty())
+        {
+            auto dist2 = stack.back().first;
+            auto node = stack.back().second;
+            stack.pop_back();
+
+            if (dist2 > heap.Bound()) continue;
+
+            if (node & leaf_bit)
+            {
+                auto i = node & ~leaf_bit;
+                heap.Push(detail::SquaredDistance<Point, d>(p, (*points_)[i]), i);
+                continue;
+            }
+
+            auto left = Left(node), right = Right(node);
+            auto dist2_left = NodeDistance(p, left);
+            auto dist2_right = NodeDistance(p, right);
+            if (dist2_left <= dist2_right)
+            {
+                stack.emplace_back(dist2_right, right);
+                stack.emplace_back(dist2_left, left);
+            }
+            else
+            {
+                stack.emplace_back(dist2_left, left);
+                stack.emplace_back(dist2_right, right);
+            }
+        }
+
+        std::vector<std::size_t> neighbors;
+        neighbors.reserve(k);
+        for (auto const& neighbor : heap.Sorted()) { neighbors.push_back(neighbor.second); }
+
+        return neighbors;
+    }
+
+private:
+    Scalar NodeDistance(Point const& p, std::size_t node) const
+    {
+        return (node & leaf_bit)
+            ? detail::SquaredDistance<Point, d>(p, (*points_)[node & ~leaf_bit])
+            : detail::SquaredDistance<Point, d>(p, boxes_[node]);
+    }
+
+    // Length of the common prefix of the points i and j, which is longer
+    // for equal points than for all distinct ones. Minimal if j lies
+    // outside of [0, n).
+    int64_t Prefix(std::size_t i, int64_t j) const
+    {
+        auto n = static_cast<int64_t>(Size());
+        if (j < 0 || j >= n) return std::numeric_limits<int64_t>::min();
+
+        auto const& points = *points_;
+        auto diff = detail::ZOrderDiffBit<Point, d>(points[i],
+            points[static_cast<std::size_t>(j)]);
+        if (diff != std::numeric_limits<int64_t>::min()) return -diff;
+
+        // a positive prefix beyond the one of any distinct points
+        return int64_t(64) - detail::UIntLogBase2(
+            static_cast<uint64_t>(i) ^ static_cast<uint64_t>(j));
+    }
+
+    void BuildNode(std::size_t i, std::vector<std::size_t>& parents)
+    {
+        auto ii = static_cast<int64_t>(i);
+
+        // direction of the range of node i
+        int64_t dir = Prefix(i, ii + 1) > Prefix(i, ii - 1) ? 1 : -1;
+        auto prefix_min = Prefix(i, ii - dir);
+
+        // upper bound for the length of the range, then the other end
+        int64_t lmax{2};
+        while (Prefix(i, ii + lmax * dir) > prefix_min) { lmax *= 2; }
+
+        int64_t l{0};
+        for (auto t = lmax / 2; t >= 1; t /= 2)
+        {
+            if (Prefix(i, ii + (l + t) * dir) > prefix_min) l += t;
+        }
+        auto j = ii + l * dir;
+
+        // split position
+        auto prefix_node = Prefix(i, j);
+        int64_t s{0};
+        for (auto t = (l + 1) / 2;; t = (t + 1) / 2)
+        {
+            if (Prefix(i, ii + (s + t) * dir) > prefix_node) s += t;
+            if (t == 1) break;
+        }
+        auto split = static_cast<std::size_t>(ii + s * dir + std::min(dir, int64_t(0)));
+
+        auto first = static_cast<std::size_t>(std::min(ii, j));
+        auto last = static_cast<std::size_t>(std::max(ii, j));
+
+        auto left = (first == split) ? (split | leaf_bit) : split;
+        auto right = (last == split + 1) ? ((split + 1) | leaf_bit) : split + 1;
+        children_[2 * i] = left;
+        children_[2 * i + 1] = right;
+
+        // parents of leaves follow the ones of the internal nodes
+        auto n_internal = boxes_.size();
+        parents[(left & leaf_bit) ? n_internal + (left & ~leaf_bit) : left] = i;
+        parents[(right & leaf_bit) ? n_internal + (right & ~leaf_bit) : right] = i;
+    }
+
+    void Build(ThreadPool& pool)
+    {
+        auto n = Size();
+        if (n < 2) return;
+
+        auto n_internal = n - 1;
+        children_.resize(2 * n_internal);
+        boxes_.resize(n_internal);
+
+        std::vector<std::size_t> parents(n_internal + n);
+        ParallelFor(pool, n_internal, [&](std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) { BuildNode(i, parents); }
+        });
+
+        // the second child arriving at a node computes its box
+        std::unique_ptr<std::atomic<uint8_t>[]> visits(
+            new std::atomic<uint8_t>[n_internal]);
+        for (std::size_t i{0}; i < n_internal; ++i) { visits[i] = 0; }
+
+        auto const& points = *points_;
+        ParallelFor(pool, n, [&](std::size_t begin, std::size_t end) {
+            for (auto leaf = begin; leaf < end; ++leaf)
+            {
+                auto node = parents[n_internal + leaf];
+                for (;;)
+                {
+                    if (visits[node].fetch_add(1, std::memory_order_acq_rel) == 0) break;
+
+                    auto left = Left(node), right = Right(node);
+                    auto box_left = (left & leaf_bit)
+                        ? Box<Point>{ points[left & ~leaf_bit], points[left & ~leaf_bit] }
+                        : boxes_[left];
+                    auto box_right = (right & leaf_bit)
+                        ? Box<Point>{ points[right & ~leaf_bit], points[right & ~leaf_bit] }
+                        : boxes_[right];
+
+                    auto& box = boxes_[node];
+                    box = box_left;
+                    for (std::size_t j{0}; j < d; ++j)
+                    {
+                        box.lo[j] = std::min(box.lo[j], box_right.lo[j]);
+                        box.hi[j] = std::max(box.hi[j], box_right.hi[j]);
+                    }
+
+                    if (node == 0) break;
+                    node = parents[node];
+                }
+            }
+        });
+    }
+
+    std::vector<Point> const* points_;
+    std::vector<std::size_t> children_;
+    std::vector<Box<Point>> boxes_;
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_RADIX_TREE_HPP
@@ -0,0 +1,173 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_RANGE_QUERY_HPP
+#define ZORDER_KNN_RANGE_QUERY_HPP
+
+#include "less.hpp"
+#include "box.hpp"
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+namespace zorder_knn
+{
+
+// Smallest point of the box in z-order which does not precede p, p must
+// not follow box.hi in z-order. Called BIGMIN by Tropf and Herzog, the
+// box is split at the most significant bit of the z-order in which its
+// corners differ until p precedes the lower corner of the remaining box.
+//
+// As Less orders each coordinate by sign first and then by magnitude,
+// which is inverted for negative numbers, the z-order is monotone in
+// each coordinate and box.lo and box.hi are the first and last points of
+// any box.
+template <typename Point, std::size_t d>
+Point
+BigMin(Point const& p, Box<Point> const& box)
+{
+    Less<Point, d> less;
+    assert(!less(box.hi, p));
+
+    auto b = box;
+    while (less(b.lo, p))
+    {
+        Box<Point> lower, upper;
+        if (!detail::SplitBox<Point, d>(b, lower, upper)) break;
+
+        b = less(lower.hi, p) ? upper : lower;
+    }
+
+    return b.lo;
+}
+
+// Largest point of the box in z-order which does not follow p, p must not
+// precede box.lo in z-order. Called LITMAX by Tropf and Herzog.
+template <typename Point, std::size_t d>
+Point
+LitMax(Point const& p, Box<Point> const& box)
+{
+    Less<Point, d> less;
+    assert(!less(p, box.lo));
+
+    auto b = box;
+    while (less(p, b.hi))
+    {
+        Box<Point> lower, upper;
+        if (!detail::SplitBox<Point, d>(b, lower, upper)) break;
+
+        b = less(p, upper.lo) ? lower : upper;
+    }
+
+    return b.hi;
+}
+
+namespace detail
+{
+
+// Ranges of at most this many points are scanned.
+constexpr std::size_t range_query_leaf_size = 32;
+
+// Call f(i) for the points [first, last) within the box in z-order, all
+// of which lie within the z-range [box.lo, box.hi]. If the middle point
+// lies outside the box, the search continues below its LITMAX and above
+// its BIGMIN.
+template <typename Point, std::size_t d, typename F>
+void
+ForEachInBoxRange(std::vector<Point> const& points, Box<Point> const& box,
+    std::size_t first, std::size_t last, F& f)
+{
+    if (last - first <= range_query_leaf_size)
+    {
+        for (auto i = first; i < last; ++i)
+        {
+            if (Contains<Point, d>(box, points[i])) f(i);
+        }
+
+        return;
+    }
+
+    auto mid = first + (last - first) / 2;
+    auto const& p = points[mid];
+
+    if (Contains<Point, d>(box, p))
+    {
+        ForEachInBoxRange<Point, d>(points, box, first, mid, f);
+        f(mid);
+        ForEachInBoxRange<Point, d>(points, box, mid + 1, last, f);
+        return;
+    }
+
+    Less<Point, d> less;
+    auto begin = points.begin();
+
+    auto litmax = LitMax<Point, d>(p, box);
+    auto lo_last = static_cast<std::size_t>(
+        std::upper_bound(begin + first, begin + mid, litmax, less) - begin);
+    ForEachInBoxRange<Point, d>(points, box, first, lo_last, f);
+
+    auto bigmin = BigMin<Point, d>(p, box);
+    auto hi_first = static_cast<std::size_t>(
+        std::lower_bound(begin + mid + 1, begin + last, bigmin, less) - begin);
+    ForEachInBoxRange<Point, d>(points, box, hi_first, last, f);
+}
+
+} // namespace detail
+
+// Call f(i) for all points sorted_points[i] within the box, in z-order.
+// Ranges of points outside the box are skipped by the BIGMIN/LITMAX range
+// search of Tropf and Herzog, so that the cost of a query grows with the
+// number of points found and only logarithmically with the number of
+// points.
+template <typename Point, std::size_t d, typename F>
+void
+ForEachInBox(std::vector<Point> const& sorted_points, Box<Point> const& box,
+    F f)
+{
+    Less<Point, d> less;
+    auto begin = sorted_points.begin();
+
+    auto first = static_cast<std::size_t>(std::lower_bound(begin,
+        sorted_points.end(), box.lo, less) - begin);
+    auto last = static_cast<std::size_t>(std::upper_bound(begin + first,
+        sorted_points.end(), box.hi, less) - begin);
+
+    detail::ForEachInBoxRange<Point, d>(sorted_points, box, first, last, f);
+}
+
+// Indices of all points of sorted_points within the box, in z-order.
+template <typename Point, std::size_t d>
+std::vector<std::size_t>
+FindInBox(std::vector<Point> const& sorted_points, Box<Point> const& box)
+{
+    std::vector<std::size_t> found;
+    ForEachInBox<Point, d>(sorted_points, box,
+        [&](std::size_t i) { found.push_back(i); });
+
+    return found;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_RANGE_QUERY_HPP
@@ -0,0 +1,177 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_RESORT_HPP
+#define ZORDER_KNN_RESORT_HPP
+
+#include "sort.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+// How Resort() restored the z-order.
+enum class ResortMethod
+{
+    // the points were sorted already
+    None,
+    // a few sorted runs were merged
+    Merge,
+    // each point was moved into place by insertion
+    Insertion,
+    // the points were sorted by Sort()
+    Sort
+};
+
+struct ResortOptions
+{
+    // Merge the sorted runs if there are at most this many.
+    std::size_t max_runs = 64;
+
+    // Average number of moves per point after which the insertion pass
+    // gives up and falls back to Sort().
+    std::size_t max_moves_per_point = 8;
+};
+
+namespace detail
+{
+
+// Start of each maximal sorted run of [first, last), the scan stops after
+// finding more than max(max_runs, 1) runs.
+template <typename RandomIt, typename Less>
+std::vector<RandomIt>
+FindSortedRuns(RandomIt first, RandomIt last, Less less, std::size_t max_runs)
+{
+    max_runs = std::max(max_runs, std::size_t(1));
+
+    std::vector<RandomIt> runs{ first };
+    for (auto it = first + 1; it < last && runs.size() <= max_runs; ++it)
+    {
+        if (less(*it, *(it - 1))) runs.push_back(it);
+    }
+
+    return runs;
+}
+
+// Merge adjacent sorted runs pairwise until a single one is left.
+template <typename RandomIt, typename Less>
+void
+MergeSortedRuns(std::vector<RandomIt> runs, RandomIt last, Less less)
+{
+    while (runs.size() > 1)
+    {
+        std::vector<RandomIt> merged;
+        for (std::size_t i{0}; i < runs.size(); i += 2)
+        {
+            merged.push_back(runs[i]);
+            if (i + 1 == runs.size()) break;
+
+            auto run_last = (i + 2 < runs.size()) ? runs[i + 2] : last;
+            std::inplace_merge(runs[i], runs[i + 1], run_last, less);
+        }
+
+        runs = std::move(merged);
+    }
+}
+
+// Insertion sort of [first, last) giving up once the number of moves
+// exceeds max_moves_per_point per point inserted so far, plus a slack for
+// the first points, returns false in that case.
+template <typename RandomIt, typename Less>
+bool
+BoundedInsertionSort(RandomIt first, RandomIt last, Less less,
+    std::size_t max_moves_per_point)
+{
+    constexpr std::size_t slack = 256;
+
+    std::size_t nmoves{0};
+    for (auto it = first + 1; it < last; ++it)
+    {
+        if (!less(*it, *(it - 1))) continue;
+
+        auto max_moves = max_moves_per_point *
+            (static_cast<std::size_t>(it - first) + slack);
+
+        auto value = std::move(*it);
+        auto jt = it;
+        do
+        {
+            *jt = std::move(*(jt - 1));
+            --jt;
+        } while (jt != first && less(value, *(jt - 1)) && ++nmoves <= max_moves);
+
+        *jt = std::move(value);
+        if (nmoves > max_moves) return false;
+    }
+
+    return true;
+}
+
+} // namespace detail
+
+// Restore the z-order of points which were sorted by Less and have moved
+// since, e.g. the particles of a simulation between two frames. A scan
+// for sorted runs detects points still in order, a few runs are merged,
+// and many short runs are resolved by an insertion pass with a bounded
+// number of moves, so that coherent motion costs close to O(n). If the
+// points are too disordered, they are sorted by Sort(). Elements are
+// ordered by the points proj(*it), see Sort().
+template <typename Point, std::size_t d, typename RandomIt,
+    typename Proj = detail::Identity>
+ResortMethod
+Resort(RandomIt first, RandomIt last, Proj proj = Proj(),
+    ResortOptions const& options = ResortOptions())
+{
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    auto less = [&](Value const& a, Value const& b) {
+        return Less<Point, d>()(detail::Invoke(proj, a), detail::Invoke(proj, b));
+    };
+
+    if (last - first < 2) return ResortMethod::None;
+
+    auto runs = detail::FindSortedRuns(first, last, less, options.max_runs);
+    if (runs.size() == 1) return ResortMethod::None;
+
+    if (runs.size() <= options.max_runs)
+    {
+        detail::MergeSortedRuns(std::move(runs), last, less);
+        return ResortMethod::Merge;
+    }
+
+    if (detail::BoundedInsertionSort(first, last, less,
+            options.max_moves_per_point))
+    {
+        return ResortMethod::Insertion;
+    }
+
+    Sort<Point, d>(first, last, proj);
+    return ResortMethod::Sort;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_RESORT_HPP
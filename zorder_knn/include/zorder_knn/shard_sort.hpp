@@ -0,0 +1,293 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_SHARD_SORT_HPP
+#define ZORDER_KNN_SHARD_SORT_HPP
+
+#include "merge.hpp"
+#include "sort.hpp"
+
+#include <cstddef>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+// Point-to-point exchange between the shards of a ShardSort(). A transport
+// provides
+//
+//   std::size_t NumShards() const;
+//   std::size_t Rank() const;
+//
+//   // element r of the result is send of rank r
+//   template <typename T>
+//   std::vector<std::vector<T>> AllGather(std::vector<T> const& send);
+//
+//   // send[r] goes to rank r, element r of the result comes from rank r
+//   template <typename T>
+//   std::vector<std::vector<T>> AllToAll(
+//       std::vector<std::vector<T>> const& send);
+//
+// where T is trivially copyable, so a transport between processes may
+// send the bytes of the vectors, e.g. by MPI_Allgatherv() and
+// MPI_Alltoallv(). All shards call the collectives in the same order.
+//
+// LoopbackTransport connects shards running as threads of one process.
+// All shards share a LoopbackHub, which has to outlive them.
+class LoopbackHub
+{
+public:
+    explicit LoopbackHub(std::size_t nshards)
+        : slots_(std::max(nshards, std::size_t(1)), nullptr), arrived_{0},
+          generation_{0}
+    {
+    }
+
+    LoopbackHub(LoopbackHub const&) = delete;
+    LoopbackHub& operator=(LoopbackHub const&) = delete;
+
+    std::size_t NumShards() const { return slots_.size(); }
+
+    // Publish the buffer of a rank and wait until all ranks did so.
+    void Post(std::size_t rank, void const* buffer)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots_[rank] = buffer;
+        }
+        Barrier();
+    }
+
+    void const* Slot(std::size_t rank) const { return slots_[rank]; }
+
+    void Barrier()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto generation = generation_;
+        if (++arrived_ == slots_.size())
+        {
+            arrived_ = 0;
+            ++generation_;
+            cv_.notify_all();
+        }
+        else
+        {
+            cv_.wait(lock, [&] { return generation_ != generation; });
+        }
+    }
+
+private:
+    std::vector<void const*> slots_;
+    std::size_t arrived_;
+    std::size_t generation_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+class LoopbackTransport
+{
+public:
+    LoopbackTransport(LoopbackHub& hub, std::size_t rank)
+        : hub_(hub), rank_{rank}
+    {
+    }
+
+    std::size_t NumShards() const { return hub_.NumShards(); }
+    std::size_t Rank() const { return rank_; }
+
+    template <typename T>
+    std::vector<std::vector<T>> AllGather(std::vector<T> const& send)
+    {
+        hub_.Post(rank_, &send);
+
+        std::vector<std::vector<T>> recv(NumShards());
+        for (std::size_t r{0}; r < recv.size(); ++r)
+        {
+            recv[r] = *static_cast<std::vector<T> const*>(hub_.Slot(r));
+        }
+
+        // the buffers of the other ranks are in use until all copied them
+        hub_.Barrier();
+        return recv;
+    }
+
+    template <typename T>
+    std::vector<std::vector<T>> AllToAll(
+        std::vector<std::vector<T>> const& send)
+    {
+        hub_.Post(rank_, &send);
+
+        std::vector<std::vector<T>> recv(NumShards());
+        for (std::size_t r{0}; r < recv.size(); ++r)
+        {
+            recv[r] = (*static_cast<std::vector<std::vector<T>> const*>(
+                hub_.Slot(r)))[rank_];
+        }
+
+        hub_.Barrier();
+        return recv;
+    }
+
+private:
+    LoopbackHub& hub_;
+    std::size_t rank_;
+};
+
+struct ShardSortStats
+{
+    std::size_t local_size = 0;   // points of this shard before sorting
+    std::size_t shard_size = 0;   // points of this shard after sorting
+    std::size_t min_shard_size = 0;
+    std::size_t max_shard_size = 0;
+    double imbalance = 1.0;       // max_shard_size over the mean size
+};
+
+namespace detail
+{
+
+// Splitters dividing the samples of all shards, sorted by Less, into
+// nshards parts of about equal weight. A sample of shard r stands for
+// sizes[r] / samples[r].size() points.
+template <typename Point, std::size_t d>
+std::vector<Point>
+SelectSplitters(std::vector<std::vector<Point>> const& samples,
+    std::vector<std::size_t> const& sizes, std::size_t nshards)
+{
+    std::vector<std::pair<Point, double>> weighted;
+    double total{0.0};
+    for (std::size_t r{0}; r < samples.size(); ++r)
+    {
+        if (samples[r].empty()) continue;
+
+        auto weight = static_cast<double>(sizes[r])
+            / static_cast<double>(samples[r].size());
+        for (auto const& p : samples[r]) { weighted.emplace_back(p, weight); }
+        total += static_cast<double>(sizes[r]);
+    }
+
+    Less<Point, d> less;
+    std::sort(weighted.begin(), weighted.end(),
+        [&](std::pair<Point, double> const& a, std::pair<Point, double> const& b) {
+            return less(a.first, b.first);
+        });
+
+    std::vector<Point> splitters;
+    double sum{0.0};
+    std::size_t i{0};
+    for (std::size_t j{1}; j < nshards && !weighted.empty(); ++j)
+    {
+        auto target = total * static_cast<double>(j)
+            / static_cast<double>(nshards);
+        while (i + 1 < weighted.size() && sum + weighted[i].second < target)
+        {
+            sum += weighted[i++].second;
+        }
+        splitters.push_back(weighted[i].first);
+    }
+
+    return splitters;
+}
+
+} // namespace detail
+
+// Sort points distributed over the shards of the transport in z-order by
+// sample sort. Every shard sorts its points by Sort() and contributes
+// oversampling evenly spaced samples. The samples of all shards, weighted
+// by the number of points they stand for, yield NumShards() - 1
+// splitters. Each shard splits its sorted points at the splitters, sends
+// part r to rank r and merges the parts it receives by MergeSorted().
+//
+// Afterwards the points of each shard are sorted by Less and precede the
+// ones of all higher ranks. Points equal to a splitter belong to the lower
+// shard, hence many duplicates may unbalance the shards. All shards have
+// to call ShardSort() collectively.
+template <typename Point, std::size_t d, typename Transport>
+ShardSortStats
+ShardSort(Transport& transport, std::vector<Point>& points,
+    std::size_t oversampling = 64)
+{
+    auto nshards = transport.NumShards();
+
+    ShardSortStats stats;
+    stats.local_size = points.size();
+
+    Sort<Point, d>(points.begin(), points.end());
+
+    auto n = points.size();
+    auto nsamples = std::min(n, oversampling);
+    std::vector<Point> samples;
+    samples.reserve(nsamples);
+    for (std::size_t i{0}; i < nsamples; ++i)
+    {
+        samples.push_back(points[(2 * i + 1) * n / (2 * nsamples)]);
+    }
+
+    auto sizes = transport.AllGather(std::vector<std::size_t>{n});
+    std::vector<std::size_t> local_sizes;
+    for (auto const& size : sizes) { local_sizes.push_back(size.front()); }
+
+    auto splitters = detail::SelectSplitters<Point, d>(
+        transport.AllGather(samples), local_sizes, nshards);
+
+    Less<Point, d> less;
+    std::vector<std::vector<Point>> parts(nshards);
+    auto first = points.begin();
+    for (std::size_t r{0}; r < nshards; ++r)
+    {
+        auto last = r < splitters.size()
+            ? std::upper_bound(first, points.end(), splitters[r], less)
+            : points.end();
+        parts[r].assign(first, last);
+        first = last;
+    }
+
+    std::vector<Point>().swap(points);
+    points = MergeSorted<Point, d>(transport.AllToAll(parts));
+    stats.shard_size = points.size();
+
+    auto shard_sizes = transport.AllGather(std::vector<std::size_t>{points.size()});
+    std::size_t total{0};
+    stats.min_shard_size = stats.shard_size;
+    for (auto const& size : shard_sizes)
+    {
+        total += size.front();
+        stats.min_shard_size = std::min(stats.min_shard_size, size.front());
+        stats.max_shard_size = std::max(stats.max_shard_size, size.front());
+    }
+
+    if (total > 0)
+    {
+        stats.imbalance = static_cast<double>(stats.max_shard_size)
+            * static_cast<double>(nshards) / static_cast<double>(total);
+    }
+
+    return stats;
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_SHARD_SORT_HPP
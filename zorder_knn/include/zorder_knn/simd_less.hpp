@@ -0,0 +1,582 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_SIMD_LESS_HPP
+#define ZORDER_KNN_SIMD_LESS_HPP
+
+#include "less.hpp"
+#include "key.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// The instruction set is chosen at compile time, e.g. by -mavx2 or
+// -march=native. Define ZORDER_KNN_NO_SIMD to use the scalar fallback.
+#if !defined(ZORDER_KNN_NO_SIMD)
+#if defined(__AVX2__)
+#define ZORDER_KNN_SIMD_AVX2
+#endif
+#if defined(__AVX512F__) && defined(__AVX512CD__)
+#define ZORDER_KNN_SIMD_AVX512
+#endif
+#endif
+
+#if defined(ZORDER_KNN_SIMD_AVX2) || defined(ZORDER_KNN_SIMD_AVX512)
+#include <immintrin.h>
+#endif
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+namespace simd
+{
+
+// Each instruction set provides a vector type F of Scalar coordinates, a
+// vector type I of integers of the same width and a mask type M.
+// XorMsb() computes FloatXorMsb() for each lane, where lanes whose signs
+// differ yield the largest integer.
+
+#if defined(ZORDER_KNN_SIMD_AVX2)
+
+struct Avx2Float
+{
+    using Scalar = float;
+    using F = __m256;
+    using I = __m256i;
+    using M = __m256i;
+    static constexpr std::size_t width = 8;
+
+    static F Load(float const* x) { return _mm256_loadu_ps(x); }
+    static F Set1(float x) { return _mm256_set1_ps(x); }
+    static I Lowest() { return _mm256_set1_epi32(std::numeric_limits<int32_t>::min()); }
+
+    static I
+    XorMsb(F p, F q)
+    {
+        auto const zero = _mm256_setzero_si256();
+        auto const bias = _mm256_set1_epi32(127);
+
+        auto pa = _mm256_and_si256(_mm256_castps_si256(p), _mm256_set1_epi32(0x7fffffff));
+        auto qa = _mm256_and_si256(_mm256_castps_si256(q), _mm256_set1_epi32(0x7fffffff));
+
+        auto pe = _mm256_srli_epi32(pa, 23);
+        auto qe = _mm256_srli_epi32(qa, 23);
+
+        // zero shares the exponent of subnormal numbers, inf and nan map to 0
+        auto one = _mm256_set1_epi32(1);
+        auto e_inf = _mm256_set1_epi32(0xff);
+        auto p_exp = _mm256_andnot_si256(_mm256_cmpeq_epi32(pe, e_inf),
+            _mm256_sub_epi32(_mm256_max_epi32(pe, one), bias));
+        auto q_exp = _mm256_andnot_si256(_mm256_cmpeq_epi32(qe, e_inf),
+            _mm256_sub_epi32(_mm256_max_epi32(qe, one), bias));
+
+        auto sig = _mm256_set1_epi32(0x007fffff);
+        auto hidden = _mm256_set1_epi32(0x00800000);
+        auto p_sig = _mm256_or_si256(_mm256_and_si256(pa, sig),
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(pe, zero), hidden));
+        auto q_sig = _mm256_or_si256(_mm256_and_si256(qa, sig),
+            _mm256_andnot_si256(_mm256_cmpeq_epi32(qe, zero), hidden));
+
+        // xor < 2^24 converts exactly, its exponent is the msb
+        auto xor_sig = _mm256_xor_si256(p_sig, q_sig);
+        auto msb = _mm256_sub_epi32(_mm256_srli_epi32(
+            _mm256_castps_si256(_mm256_cvtepi32_ps(xor_sig)), 23), bias);
+
+        auto y_eq = _mm256_blendv_epi8(p_exp,
+            _mm256_add_epi32(p_exp, _mm256_sub_epi32(msb, _mm256_set1_epi32(23))),
+            _mm256_cmpgt_epi32(xor_sig, zero));
+        auto y = _mm256_blendv_epi8(_mm256_max_epi32(p_exp, q_exp), y_eq,
+            _mm256_cmpeq_epi32(p_exp, q_exp));
+
+        y = _mm256_blendv_epi8(y, Lowest(), _mm256_cmpeq_epi32(pa, qa));
+
+        auto zero_ps = _mm256_setzero_ps();
+        auto sign = _mm256_xor_si256(
+            _mm256_castps_si256(_mm256_cmp_ps(p, zero_ps, _CMP_LT_OQ)),
+            _mm256_castps_si256(_mm256_cmp_ps(q, zero_ps, _CMP_LT_OQ)));
+        return _mm256_blendv_epi8(y,
+            _mm256_set1_epi32(std::numeric_limits<int32_t>::max()), sign);
+    }
+
+    static M Greater(I a, I b) { return _mm256_cmpgt_epi32(a, b); }
+    static I Blend(M m, I a, I b) { return _mm256_blendv_epi8(a, b, m); }
+    static F Blend(M m, F a, F b) { return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(m)); }
+
+    static uint32_t
+    LessMask(F a, F b)
+    {
+        return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ)));
+    }
+
+    // Lanes holding the maximum of y.
+    static uint32_t
+    MaxMask(I y)
+    {
+        auto m = _mm256_max_epi32(y, _mm256_permute2x128_si256(y, y, 1));
+        m = _mm256_max_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = _mm256_max_epi32(m, _mm256_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<uint32_t>(_mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpeq_epi32(y, m))));
+    }
+
+    // Lane l of y.
+    static int64_t
+    Extract(I y, std::size_t l)
+    {
+        alignas(32) int32_t lanes[width];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), y);
+        return lanes[l];
+    }
+};
+
+struct Avx2Double
+{
+    using Scalar = double;
+    using F = __m256d;
+    using I = __m256i;
+    using M = __m256i;
+    static constexpr std::size_t width = 4;
+
+    static F Load(double const* x) { return _mm256_loadu_pd(x); }
+    static F Set1(double x) { return _mm256_set1_pd(x); }
+    static I Lowest() { return _mm256_set1_epi64x(std::numeric_limits<int64_t>::min()); }
+
+    static I
+    Max(I a, I b)
+    {
+        return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+    }
+
+    static I
+    XorMsb(F p, F q)
+    {
+        auto const zero = _mm256_setzero_si256();
+        auto const bias = _mm256_set1_epi64x(1023);
+
+        auto abs = _mm256_set1_epi64x(0x7fffffffffffffffll);
+        auto pa = _mm256_and_si256(_mm256_castpd_si256(p), abs);
+        auto qa = _mm256_and_si256(_mm256_castpd_si256(q), abs);
+
+        auto pe = _mm256_srli_epi64(pa, 52);
+        auto qe = _mm256_srli_epi64(qa, 52);
+
+        // zero shares the exponent of subnormal numbers, inf and nan map to 0
+        auto one = _mm256_set1_epi64x(1);
+        auto e_inf = _mm256_set1_epi64x(0x7ff);
+        auto p_exp = _mm256_andnot_si256(_mm256_cmpeq_epi64(pe, e_inf),
+            _mm256_sub_epi64(Max(pe, one), bias));
+        auto q_exp = _mm256_andnot_si256(_mm256_cmpeq_epi64(qe, e_inf),
+            _mm256_sub_epi64(Max(qe, one), bias));
+
+        auto sig = _mm256_set1_epi64x(0x000fffffffffffffll);
+        auto hidden = _mm256_set1_epi64x(0x0010000000000000ll);
+        auto p_sig = _mm256_or_si256(_mm256_and_si256(pa, sig),
+            _mm256_andnot_si256(_mm256_cmpeq_epi64(pe, zero), hidden));
+        auto q_sig = _mm256_or_si256(_mm256_and_si256(qa, sig),
+            _mm256_andnot_si256(_mm256_cmpeq_epi64(qe, zero), hidden));
+
+        // xor < 2^52 converts exactly by subtracting 2^52 from the double
+        // whose significand it forms, its exponent is the msb; only the
+        // smallest normal and a subnormal number differ in bit 52
+        auto xor_sig = _mm256_xor_si256(p_sig, q_sig);
+        auto magic = _mm256_set1_epi64x(0x4330000000000000ll);
+        auto xor_pd = _mm256_sub_pd(
+            _mm256_castsi256_pd(_mm256_or_si256(xor_sig, magic)),
+            _mm256_castsi256_pd(magic));
+        auto msb = _mm256_sub_epi64(_mm256_srli_epi64(
+            _mm256_castpd_si256(xor_pd), 52), bias);
+        msb = _mm256_blendv_epi8(msb, _mm256_set1_epi64x(52),
+            _mm256_cmpgt_epi64(xor_sig, _mm256_set1_epi64x(0x000fffffffffffffll)));
+
+        auto y_eq = _mm256_blendv_epi8(p_exp,
+            _mm256_add_epi64(p_exp, _mm256_sub_epi64(msb, _mm256_set1_epi64x(52))),
+            _mm256_cmpgt_epi64(xor_sig, zero));
+        auto y = _mm256_blendv_epi8(Max(p_exp, q_exp), y_eq,
+            _mm256_cmpeq_epi64(p_exp, q_exp));
+
+        y = _mm256_blendv_epi8(y, Lowest(), _mm256_cmpeq_epi64(pa, qa));
+
+        auto zero_pd = _mm256_setzero_pd();
+        auto sign = _mm256_xor_si256(
+            _mm256_castpd_si256(_mm256_cmp_pd(p, zero_pd, _CMP_LT_OQ)),
+            _mm256_castpd_si256(_mm256_cmp_pd(q, zero_pd, _CMP_LT_OQ)));
+        return _mm256_blendv_epi8(y,
+            _mm256_set1_epi64x(std::numeric_limits<int64_t>::max()), sign);
+    }
+
+    static M Greater(I a, I b) { return _mm256_cmpgt_epi64(a, b); }
+    static I Blend(M m, I a, I b) { return _mm256_blendv_epi8(a, b, m); }
+    static F Blend(M m, F a, F b) { return _mm256_blendv_pd(a, b, _mm256_castsi256_pd(m)); }
+
+    static uint32_t
+    LessMask(F a, F b)
+    {
+        return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)));
+    }
+
+    // Lanes holding the maximum of y.
+    static uint32_t
+    MaxMask(I y)
+    {
+        auto m = Max(y, _mm256_permute4x64_epi64(y, _MM_SHUFFLE(1, 0, 3, 2)));
+        m = Max(m, _mm256_permute4x64_epi64(m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return static_cast<uint32_t>(_mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpeq_epi64(y, m))));
+    }
+
+    // Lane l of y.
+    static int64_t
+    Extract(I y, std::size_t l)
+    {
+        alignas(32) int64_t lanes[width];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), y);
+        return lanes[l];
+    }
+};
+
+#endif // ZORDER_KNN_SIMD_AVX2
+
+#if defined(ZORDER_KNN_SIMD_AVX512)
+
+struct Avx512Float
+{
+    using Scalar = float;
+    using F = __m512;
+    using I = __m512i;
+    using M = __mmask16;
+    static constexpr std::size_t width = 16;
+
+    static F Load(float const* x) { return _mm512_loadu_ps(x); }
+    static F Set1(float x) { return _mm512_set1_ps(x); }
+    static I Lowest() { return _mm512_set1_epi32(std::numeric_limits<int32_t>::min()); }
+
+    static I
+    XorMsb(F p, F q)
+    {
+        auto const zero = _mm512_setzero_si512();
+        auto const bias = _mm512_set1_epi32(127);
+
+        auto pa = _mm512_and_si512(_mm512_castps_si512(p), _mm512_set1_epi32(0x7fffffff));
+        auto qa = _mm512_and_si512(_mm512_castps_si512(q), _mm512_set1_epi32(0x7fffffff));
+
+        auto pe = _mm512_srli_epi32(pa, 23);
+        auto qe = _mm512_srli_epi32(qa, 23);
+
+        // zero shares the exponent of subnormal numbers, inf and nan map to 0
+        auto one = _mm512_set1_epi32(1);
+        auto e_inf = _mm512_set1_epi32(0xff);
+        auto p_exp = _mm512_maskz_sub_epi32(_mm512_cmpneq_epi32_mask(pe, e_inf),
+            _mm512_max_epi32(pe, one), bias);
+        auto q_exp = _mm512_maskz_sub_epi32(_mm512_cmpneq_epi32_mask(qe, e_inf),
+            _mm512_max_epi32(qe, one), bias);
+
+        auto sig = _mm512_set1_epi32(0x007fffff);
+        auto hidden = _mm512_set1_epi32(0x00800000);
+        auto p_sig = _mm512_and_si512(pa, sig);
+        p_sig = _mm512_mask_or_epi32(p_sig, _mm512_cmpneq_epi32_mask(pe, zero),
+            p_sig, hidden);
+        auto q_sig = _mm512_and_si512(qa, sig);
+        q_sig = _mm512_mask_or_epi32(q_sig, _mm512_cmpneq_epi32_mask(qe, zero),
+            q_sig, hidden);
+
+        auto xor_sig = _mm512_xor_si512(p_sig, q_sig);
+        auto msb = _mm512_sub_epi32(_mm512_set1_epi32(31 - 23),
+            _mm512_lzcnt_epi32(xor_sig));
+
+        auto y_eq = _mm512_mask_add_epi32(p_exp,
+            _mm512_cmpneq_epi32_mask(xor_sig, zero), p_exp, msb);
+        auto y = _mm512_mask_blend_epi32(_mm512_cmpeq_epi32_mask(p_exp, q_exp),
+            _mm512_max_epi32(p_exp, q_exp), y_eq);
+
+        y = _mm512_mask_blend_epi32(_mm512_cmpeq_epi32_mask(pa, qa), y, Lowest());
+
+        auto zero_ps = _mm512_setzero_ps();
+        auto sign = static_cast<M>(_mm512_cmp_ps_mask(p, zero_ps, _CMP_LT_OQ)
+            ^ _mm512_cmp_ps_mask(q, zero_ps, _CMP_LT_OQ));
+        return _mm512_mask_blend_epi32(sign, y,
+            _mm512_set1_epi32(std::numeric_limits<int32_t>::max()));
+    }
+
+    static M Greater(I a, I b) { return _mm512_cmpgt_epi32_mask(a, b); }
+    static I Blend(M m, I a, I b) { return _mm512_mask_blend_epi32(m, a, b); }
+    static F Blend(M m, F a, F b) { return _mm512_mask_blend_ps(m, a, b); }
+
+    static uint32_t
+    LessMask(F a, F b)
+    {
+        return static_cast<uint32_t>(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ));
+    }
+};
+
+struct Avx512Double
+{
+    using Scalar = double;
+    using F = __m512d;
+    using I = __m512i;
+    using M = __mmask8;
+    static constexpr std::size_t width = 8;
+
+    static F Load(double const* x) { return _mm512_loadu_pd(x); }
+    static F Set1(double x) { return _mm512_set1_pd(x); }
+    static I Lowest() { return _mm512_set1_epi64(std::numeric_limits<int64_t>::min()); }
+
+    static I
+    XorMsb(F p, F q)
+    {
+        auto const zero = _mm512_setzero_si512();
+        auto const bias = _mm512_set1_epi64(1023);
+
+        auto abs = _mm512_set1_epi64(0x7fffffffffffffffll);
+        auto pa = _mm512_and_si512(_mm512_castpd_si512(p), abs);
+        auto qa = _mm512_and_si512(_mm512_castpd_si512(q), abs);
+
+        auto pe = _mm512_srli_epi64(pa, 52);
+        auto qe = _mm512_srli_epi64(qa, 52);
+
+        // zero shares the exponent of subnormal numbers, inf and nan map to 0
+        auto one = _mm512_set1_epi64(1);
+        auto e_inf = _mm512_set1_epi64(0x7ff);
+        auto p_exp = _mm512_maskz_sub_epi64(_mm512_cmpneq_epi64_mask(pe, e_inf),
+            _mm512_max_epi64(pe, one), bias);
+        auto q_exp = _mm512_maskz_sub_epi64(_mm512_cmpneq_epi64_mask(qe, e_inf),
+            _mm512_max_epi64(qe, one), bias);
+
+        auto sig = _mm512_set1_epi64(0x000fffffffffffffll);
+        auto hidden = _mm512_set1_epi64(0x0010000000000000ll);
+        auto p_sig = _mm512_and_si512(pa, sig);
+        p_sig = _mm512_mask_or_epi64(p_sig, _mm512_cmpneq_epi64_mask(pe, zero),
+            p_sig, hidden);
+        auto q_sig = _mm512_and_si512(qa, sig);
+        q_sig = _mm512_mask_or_epi64(q_sig, _mm512_cmpneq_epi64_mask(qe, zero),
+            q_sig, hidden);
+
+        auto xor_sig = _mm512_xor_si512(p_sig, q_sig);
+        auto msb = _mm512_sub_epi64(_mm512_set1_epi64(63 - 52),
+            _mm512_lzcnt_epi64(xor_sig));
+
+        auto y_eq = _mm512_mask_add_epi64(p_exp,
+            _mm512_cmpneq_epi64_mask(xor_sig, zero), p_exp, msb);
+        auto y = _mm512_mask_blend_epi64(_mm512_cmpeq_epi64_mask(p_exp, q_exp),
+            _mm512_max_epi64(p_exp, q_exp), y_eq);
+
+        y = _mm512_mask_blend_epi64(_mm512_cmpeq_epi64_mask(pa, qa), y, Lowest());
+
+        auto zero_pd = _mm512_setzero_pd();
+        auto sign = static_cast<M>(_mm512_cmp_pd_mask(p, zero_pd, _CMP_LT_OQ)
+            ^ _mm512_cmp_pd_mask(q, zero_pd, _CMP_LT_OQ));
+        return _mm512_mask_blend_epi64(sign, y,
+            _mm512_set1_epi64(std::numeric_limits<int64_t>::max()));
+    }
+
+    static M Greater(I a, I b) { return _mm512_cmpgt_epi64_mask(a, b); }
+    static I Blend(M m, I a, I b) { return _mm512_mask_blend_epi64(m, a, b); }
+    static F Blend(M m, F a, F b) { return _mm512_mask_blend_pd(m, a, b); }
+
+    static uint32_t
+    LessMask(F a, F b)
+    {
+        return static_cast<uint32_t>(_mm512_cmp_pd_mask(a, b, _CMP_LT_OQ));
+    }
+};
+
+#endif // ZORDER_KNN_SIMD_AVX512
+
+// Scalar fallback.
+struct NoSimd {};
+
+// Instruction set comparing a single pair of points with one coordinate
+// per lane, NoSimd if there is none.
+template <typename Scalar> struct PairIsa { using type = NoSimd; };
+
+// Instruction set comparing many points against a pivot with one point
+// per lane, NoSimd if there is none.
+template <typename Scalar> struct BatchIsa { using type = NoSimd; };
+
+#if defined(ZORDER_KNN_SIMD_AVX2)
+template <> struct PairIsa<float>  { using type = Avx2Float; };
+template <> struct PairIsa<double> { using type = Avx2Double; };
+#endif
+
+#if defined(ZORDER_KNN_SIMD_AVX512)
+template <> struct BatchIsa<float>  { using type = Avx512Float; };
+template <> struct BatchIsa<double> { using type = Avx512Double; };
+#elif defined(ZORDER_KNN_SIMD_AVX2)
+template <> struct BatchIsa<float>  { using type = Avx2Float; };
+template <> struct BatchIsa<double> { using type = Avx2Double; };
+#endif
+
+// Less with coordinate j in lane j. The coordinate with the largest
+// FloatXorMsb wins, ties go to the coordinate preceding in z-order.
+template <typename Isa, typename Point, std::size_t d>
+bool
+PairLess(Point const& p, Point const& q)
+{
+    using Scalar = typename Isa::Scalar;
+    static_assert(d <= Isa::width, "d exceeds the number of lanes");
+
+    Scalar pb[Isa::width] = {};
+    Scalar qb[Isa::width] = {};
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        pb[j] = p[j];
+        qb[j] = q[j];
+    }
+
+    auto y = Isa::XorMsb(Isa::Load(pb), Isa::Load(qb));
+    auto mask = Isa::MaxMask(y) & ((uint32_t(1) << d) - 1);
+    auto k = static_cast<std::size_t>(UIntLogBase2(mask));
+
+    return p[k] < q[k];
+}
+
+// Less for Isa::width points against the pivot with point i in lane i,
+// bit i of the result is set if points[i] precedes the pivot in z-order,
+// or follows it if pivot_first is set.
+template <typename Isa, typename Point, std::size_t d>
+uint32_t
+BatchLess(Point const* points, Point const& pivot, bool pivot_first)
+{
+    using Scalar = typename Isa::Scalar;
+
+    Scalar coords[d][Isa::width];
+    for (std::size_t i{0}; i < Isa::width; ++i)
+    {
+        for (std::size_t j{0}; j < d; ++j) { coords[j][i] = points[i][j]; }
+    }
+
+    auto pk = Isa::Load(coords[0]);
+    auto qk = Isa::Set1(pivot[0]);
+    auto x = Isa::Lowest();
+
+    for (std::size_t j{d}; j-- > 0;)
+    {
+        auto pj = Isa::Load(coords[j]);
+        auto qj = Isa::Set1(pivot[j]);
+
+        auto y = Isa::XorMsb(pj, qj);
+        auto m = Isa::Greater(y, x);
+
+        x = Isa::Blend(m, x, y);
+        pk = Isa::Blend(m, pk, pj);
+        qk = Isa::Blend(m, qk, qj);
+    }
+
+    return pivot_first ? Isa::LessMask(qk, pk) : Isa::LessMask(pk, qk);
+}
+
+template <typename Point, std::size_t d>
+bool
+Less(Point const& p, Point const& q, NoSimd*)
+{
+    return zorder_knn::Less<Point, d>()(p, q);
+}
+
+template <typename Point, std::size_t d, typename Isa>
+auto
+Less(Point const& p, Point const& q, Isa*)
+    -> typename std::enable_if<(d <= Isa::width), bool>::type
+{
+    return PairLess<Isa, Point, d>(p, q);
+}
+
+template <typename Point, std::size_t d, typename Isa>
+auto
+Less(Point const& p, Point const& q, Isa*)
+    -> typename std::enable_if<(d > Isa::width), bool>::type
+{
+    return zorder_knn::Less<Point, d>()(p, q);
+}
+
+template <typename Point, std::size_t d>
+void
+BatchLess(Point const* points, std::size_t n, Point const& pivot,
+    bool pivot_first, bool* out, NoSimd*)
+{
+    zorder_knn::Less<Point, d> less;
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        out[i] = pivot_first ? less(pivot, points[i]) : less(points[i], pivot);
+    }
+}
+
+template <typename Point, std::size_t d, typename Isa>
+void
+BatchLess(Point const* points, std::size_t n, Point const& pivot,
+    bool pivot_first, bool* out, Isa*)
+{
+    std::size_t i{0};
+    for (; i + Isa::width <= n; i += Isa::width)
+    {
+        auto mask = BatchLess<Isa, Point, d>(points + i, pivot, pivot_first);
+        for (std::size_t l{0}; l < Isa::width; ++l) { out[i + l] = (mask >> l) & 1; }
+    }
+
+    BatchLess<Point, d>(points + i, n - i, pivot, pivot_first, out + i,
+        static_cast<NoSimd*>(nullptr));
+}
+
+} // namespace simd
+
+} // namespace detail
+
+// Less computing the exponents and most significant bits of all
+// coordinates lane-parallel, yields the same order as Less.
+template <typename Point, std::size_t d>
+struct SimdLess
+{
+    bool operator()(Point const& p, Point const& q) const
+    {
+        using Isa = typename detail::simd::PairIsa<detail::PointScalar<Point>>::type;
+        return detail::simd::Less<Point, d>(p, q, static_cast<Isa*>(nullptr));
+    }
+};
+
+// Compare the n points against the pivot with one point per lane, out[i]
+// is set if points[i] precedes the pivot in z-order.
+template <typename Point, std::size_t d>
+void
+LessBatch(Point const* points, std::size_t n, Point const& pivot, bool* out)
+{
+    using Isa = typename detail::simd::BatchIsa<detail::PointScalar<Point>>::type;
+    detail::simd::BatchLess<Point, d>(points, n, pivot, false, out,
+        static_cast<Isa*>(nullptr));
+}
+
+// Compare the n points against the pivot with one point per lane, out[i]
+// is set if the pivot precedes points[i] in z-order.
+template <typename Point, std::size_t d>
+void
+GreaterBatch(Point const* points, std::size_t n, Point const& pivot, bool* out)
+{
+    using Isa = typename detail::simd::BatchIsa<detail::PointScalar<Point>>::type;
+    detail::simd::BatchLess<Point, d>(points, n, pivot, true, out,
+        static_cast<Isa*>(nullptr));
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_SIMD_LESS_HPP
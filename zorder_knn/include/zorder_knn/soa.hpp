@@ -0,0 +1,166 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_SOA_HPP
+#define ZORDER_KNN_SOA_HPP
+
+#include "sort.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#include <type_traits>
+
+namespace zorder_knn
+{
+
+// Coordinates of size points stored as structure of arrays, coordinate j
+// of point i is columns[j][i]. Scalar may be const qualified unless the
+// points are sorted in place.
+template <typename Scalar, std::size_t d>
+struct SoaPoints
+{
+    std::array<Scalar*, d> columns;
+    std::size_t size;
+};
+
+namespace detail
+{
+
+// Point i of SoaPoints, indexed by coordinate like a point.
+template <typename Scalar, std::size_t d>
+struct SoaPoint
+{
+    std::array<Scalar*, d> const* columns;
+    std::size_t i;
+
+    Scalar const& operator[](std::size_t j) const { return (*columns)[j][i]; }
+};
+
+} // namespace detail
+
+// Less on the indices of SoaPoints.
+template <typename Scalar, std::size_t d>
+struct SoaLess
+{
+    explicit SoaLess(SoaPoints<Scalar, d> const& points)
+        : columns(points.columns) {}
+
+    bool operator()(std::size_t i, std::size_t k) const
+    {
+        using Point = detail::SoaPoint<Scalar, d>;
+        return Less<Point, d>()(Point{&columns, i}, Point{&columns, k});
+    }
+
+    std::array<Scalar*, d> columns;
+};
+
+// Range of the magnitude bits of the coordinates, see KeyBitRange. Each
+// column is read with unit stride.
+template <typename Scalar, std::size_t d>
+KeyBitRange
+MakeKeyBitRange(SoaPoints<Scalar, d> const& points)
+{
+    KeyBitRange range;
+
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        auto const* column = points.columns[j];
+        for (std::size_t i{0}; i < points.size; ++i)
+        {
+            auto x = detail::FloatToFixedPoint(column[i]);
+            if (x.sig == 0) continue;
+
+            range.bit_min = std::min(range.bit_min, detail::FixedPointLsb(x));
+            range.bit_max = std::max(range.bit_max, detail::FixedPointMsb(x));
+        }
+    }
+
+    return range;
+}
+
+template <typename Scalar, std::size_t d>
+KeyLayout
+MakeKeyLayout(SoaPoints<Scalar, d> const& points)
+{
+    return MakeKeyLayout<d>(MakeKeyBitRange(points));
+}
+
+// Compute the keys of all points column by column, key i occupies the
+// words [i * layout.nwords, (i + 1) * layout.nwords).
+template <typename Scalar, std::size_t d>
+std::vector<uint64_t>
+MakeKeys(KeyLayout const& layout, SoaPoints<Scalar, d> const& points)
+{
+    std::vector<uint64_t> keys(points.size * layout.nwords, 0);
+
+    for (std::size_t j{0}; j < d; ++j)
+    {
+        auto const* column = points.columns[j];
+        for (std::size_t i{0}; i < points.size; ++i)
+        {
+            detail::KeyAddCoordinate<d>(layout, j, column[i],
+                keys.data() + i * layout.nwords);
+        }
+    }
+
+    return keys;
+}
+
+// Permutation sorting the points in z-order, see SortPermutation().
+template <typename Index = std::size_t, typename Scalar, std::size_t d>
+std::vector<Index>
+SortPermutation(SoaPoints<Scalar, d> const& points)
+{
+    auto layout = MakeKeyLayout(points);
+    auto keys = MakeKeys(layout, points);
+
+    std::vector<Index> perm(points.size);
+    std::iota(perm.begin(), perm.end(), Index(0));
+
+    detail::RadixSortKeys(keys, perm, layout.nwords, layout.nbits);
+    return perm;
+}
+
+// Sort the points in z-order in place, one column after another.
+template <typename Scalar, std::size_t d>
+void
+Sort(SoaPoints<Scalar, d> const& points)
+{
+    static_assert(!std::is_const<Scalar>::value, "columns must be mutable");
+
+    auto perm = SortPermutation(points);
+
+    std::vector<Scalar> sorted(points.size);
+    for (auto* column : points.columns)
+    {
+        for (std::size_t i{0}; i < points.size; ++i) { sorted[i] = column[perm[i]]; }
+        std::copy(sorted.begin(), sorted.end(), column);
+    }
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_SOA_HPP
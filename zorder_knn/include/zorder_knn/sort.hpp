@@ -0,0 +1,171 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_SORT_HPP
+#define ZORDER_KNN_SORT_HPP
+
+#include "key.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <numeric>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cassert>
+
+namespace zorder_knn
+{
+
+namespace detail
+{
+
+inline unsigned
+KeyDigit(uint64_t const* key, std::size_t nwords, std::size_t t)
+{
+    return static_cast<unsigned>(key[nwords - 1 - t / 8] >> (8 * (t % 8))) & 0xffu;
+}
+
+// LSD radix sort of keys by 8-bit digits, perm is permuted along with the
+// keys. Digits which are equal for all keys are skipped.
+template <typename Index>
+void
+RadixSortKeys(std::vector<uint64_t>& keys, std::vector<Index>& perm,
+    std::size_t nwords, std::size_t nbits)
+{
+    auto n = perm.size();
+    auto ndigits = (nbits + 7) / 8;
+
+    std::vector<std::size_t> counts(ndigits * 256, 0);
+    for (std::size_t i{0}; i < n; ++i)
+    {
+        auto const* key = keys.data() + i * nwords;
+        for (std::size_t t{0}; t < ndigits; ++t)
+        {
+            ++counts[t * 256 + KeyDigit(key, nwords, t)];
+        }
+    }
+
+    std::vector<uint64_t> keys_tmp(keys.size());
+    std::vector<Index> perm_tmp(n);
+
+    for (std::size_t t{0}; t < ndigits; ++t)
+    {
+        auto* count = counts.data() + t * 256;
+        if (std::any_of(count, count + 256,
+            [n](std::size_t c) { return c == n; }))
+        {
+            continue;
+        }
+
+        std::size_t offset{0};
+        for (std::size_t b{0}; b < 256; ++b)
+        {
+            auto c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        for (std::size_t i{0}; i < n; ++i)
+        {
+            auto const* key = keys.data() + i * nwords;
+            auto i1 = count[KeyDigit(key, nwords, t)]++;
+            std::copy(key, key + nwords, keys_tmp.data() + i1 * nwords);
+            perm_tmp[i1] = perm[i];
+        }
+
+        keys.swap(keys_tmp);
+        perm.swap(perm_tmp);
+    }
+}
+
+template <typename Index, typename Array>
+void
+ApplyPermutation(std::vector<Index> const& perm, Array& array)
+{
+    Array out(perm.size());
+    for (std::size_t i{0}; i < perm.size(); ++i) { out[i] = std::move(array[perm[i]]); }
+    array.swap(out);
+}
+
+} // namespace detail
+
+// Permutation sorting the points proj(*it) for it in [first, last) in
+// z-order, i.e. element i of the sorted sequence is first[perm[i]]. The
+// projection is a function object or a pointer to a data member or const
+// member function returning the point of an element, so large records
+// are never moved while sorting. Index may be narrower than std::size_t,
+// e.g. uint32_t, to halve the memory of the permutation.
+template <typename Point, std::size_t d, typename Index = std::size_t,
+    typename ForwardIt, typename Proj = detail::Identity>
+std::vector<Index>
+SortPermutation(ForwardIt first, ForwardIt last, Proj proj = Proj())
+{
+    auto layout = MakeKeyLayout<Point, d>(first, last, proj);
+    auto keys = MakeKeys<Point, d>(layout, first, last, proj);
+
+    auto n = static_cast<std::size_t>(std::distance(first, last));
+    assert(n - 1 <= std::numeric_limits<Index>::max() || n == 0);
+
+    std::vector<Index> perm(n);
+    std::iota(perm.begin(), perm.end(), Index(0));
+
+    detail::RadixSortKeys(keys, perm, layout.nwords, layout.nbits);
+    return perm;
+}
+
+// Reorder the arrays by the permutation, element i of each array becomes
+// its element perm[i] before. The arrays are std::vector or alike and
+// have perm.size() elements each. One array is reordered after another,
+// which keeps the cache to the elements of a single array.
+template <typename Index, typename... Arrays>
+void
+ApplyPermutation(std::vector<Index> const& perm, Arrays&... arrays)
+{
+    using expand = int[];
+    (void)expand{ 0, (detail::ApplyPermutation(perm, arrays), 0)... };
+}
+
+// Sort points in z-order, i.e. in the same order as std::sort() with
+// Less<Point, d>, by computing the morton key of each point once and
+// radix sorting the keys. Elements are sorted by the points proj(*it),
+// see SortPermutation().
+template <typename Point, std::size_t d, typename RandomIt,
+    typename Proj = detail::Identity>
+void
+Sort(RandomIt first, RandomIt last, Proj proj = Proj())
+{
+    auto perm = SortPermutation<Point, d>(first, last, proj);
+
+    using Value = typename std::iterator_traits<RandomIt>::value_type;
+    std::vector<Value> sorted;
+    sorted.reserve(perm.size());
+    for (auto i : perm) { sorted.push_back(std::move(first[i])); }
+
+    std::move(sorted.begin(), sorted.end(), first);
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_SORT_HPP
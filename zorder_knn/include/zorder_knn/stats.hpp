@@ -0,0 +1,152 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_STATS_HPP
+#define ZORDER_KNN_STATS_HPP
+
+#include "less.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+// Branch counts of Less, see CountStats.
+struct LessCounters
+{
+    // Comparisons, and comparisons decided by a pair of coordinates of
+    // different sign.
+    uint64_t ncompare = 0;
+    uint64_t nsign_mismatch = 0;
+
+    // Comparisons of equal points.
+    uint64_t nequal = 0;
+
+    // Pairs of coordinates passed to the XorMsb policy which are equal or
+    // negated, which share their exponent, or whose exponents differ.
+    uint64_t ncoord_equal = 0;
+    uint64_t ncoord_equal_exp = 0;
+    uint64_t ncoord_diff_exp = 0;
+
+    // Per axis k, the comparisons decided by a sign mismatch of axis k and
+    // by the most significant differing bit of axis k.
+    std::vector<uint64_t> axis_sign_mismatch;
+    std::vector<uint64_t> axis_wins;
+
+    void Reset() { *this = LessCounters(); }
+
+    // Write the counts in a human readable form.
+    void Dump(std::ostream& os) const
+    {
+        os << "comparisons:        " << ncompare << '\n'
+           << "sign mismatch:      " << nsign_mismatch << '\n'
+           << "equal points:       " << nequal << '\n'
+           << "coordinates equal:  " << ncoord_equal << '\n'
+           << "equal exponents:    " << ncoord_equal_exp << '\n'
+           << "exponents differ:   " << ncoord_diff_exp << '\n';
+
+        auto naxes = std::max(axis_sign_mismatch.size(), axis_wins.size());
+        for (std::size_t k{0}; k < naxes; ++k)
+        {
+            os << "axis " << k << ": sign mismatch "
+               << Count(axis_sign_mismatch, k) << ", wins "
+               << Count(axis_wins, k) << '\n';
+        }
+    }
+
+private:
+    static uint64_t Count(std::vector<uint64_t> const& counts, std::size_t k)
+    {
+        return k < counts.size() ? counts[k] : 0;
+    }
+};
+
+namespace detail
+{
+
+inline void
+CountAxis(std::vector<uint64_t>& counts, std::size_t k)
+{
+    if (counts.size() <= k) counts.resize(k + 1, 0);
+    ++counts[k];
+}
+
+} // namespace detail
+
+// Policy of Less counting the branches taken in the counters of the
+// calling thread, e.g.
+//
+//   using StatsLess = Less<Point, d, XorMsbTable, CountStats>;
+//   CountStats::Counters().Reset();
+//   std::sort(points.begin(), points.end(), StatsLess());
+//   CountStats::Counters().Dump(std::cout);
+struct CountStats
+{
+    static LessCounters& Counters()
+    {
+        static thread_local LessCounters counters;
+        return counters;
+    }
+
+    static void Compare() { ++Counters().ncompare; }
+
+    static void SignMismatch(std::size_t k)
+    {
+        ++Counters().nsign_mismatch;
+        detail::CountAxis(Counters().axis_sign_mismatch, k);
+    }
+
+    // Classify the pair of coordinates like detail::FloatXorMsb().
+    template <typename Scalar>
+    static void Coordinate(Scalar p, Scalar q)
+    {
+        auto& counters = Counters();
+        if (detail::AbsEqual(p, q))
+        {
+            ++counters.ncoord_equal;
+        }
+        else if (detail::CoordinateExp(p) == detail::CoordinateExp(q))
+        {
+            ++counters.ncoord_equal_exp;
+        }
+        else
+        {
+            ++counters.ncoord_diff_exp;
+        }
+    }
+
+    static void Decided(std::size_t k, bool equal)
+    {
+        if (equal)
+            ++Counters().nequal;
+        else
+            detail::CountAxis(Counters().axis_wins, k);
+    }
+};
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_STATS_HPP
@@ -0,0 +1,265 @@
+// This file is part of zorder_knn.
+//
+// Copyright(c) 2010, 2021 Sebastian Lipponer
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+
+#ifndef ZORDER_KNN_THREAD_POOL_HPP
+#define ZORDER_KNN_THREAD_POOL_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace zorder_knn
+{
+
+class ThreadPool;
+
+namespace detail
+{
+
+struct WorkerId
+{
+    ThreadPool const* pool;
+    std::size_t index;
+};
+
+inline WorkerId&
+CurrentWorker()
+{
+    static thread_local WorkerId id{nullptr, 0};
+    return id;
+}
+
+} // namespace detail
+
+inline std::size_t
+DefaultNumThreads()
+{
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+// Work-stealing thread pool. Each thread owns a task queue; tasks
+// submitted from within a task go to the queue of the executing thread,
+// which processes its own queue in LIFO order while idle threads steal
+// the oldest tasks of other queues. The thread calling Wait() takes part
+// in executing tasks, i.e. a pool of nthreads threads spawns nthreads - 1
+// worker threads.
+//
+// Tasks may be submitted from any number of tasks concurrently, but only
+// one thread outside of the pool may submit tasks and wait for them.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(std::size_t nthreads = DefaultNumThreads())
+        : pending_{0}, queued_{0}, next_{0}, stop_{false}
+    {
+        nthreads = std::max(nthreads, std::size_t(1));
+        for (std::size_t i{0}; i < nthreads; ++i)
+        {
+            queues_.emplace_back(new Queue);
+        }
+        for (std::size_t i{1}; i < nthreads; ++i)
+        {
+            threads_.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& t : threads_) { t.join(); }
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    std::size_t NumThreads() const { return queues_.size(); }
+
+    template <typename Task>
+    void Submit(Task&& task)
+    {
+        auto const& worker = detail::CurrentWorker();
+        auto i = (worker.pool == this) ? worker.index
+                                       : next_++ % queues_.size();
+
+        ++pending_;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++queued_;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues_[i]->mutex);
+            queues_[i]->tasks.emplace_back(std::forward<Task>(task));
+        }
+        cv_.notify_one();
+    }
+
+    // Execute tasks until all submitted tasks, including the ones
+    // submitted by tasks, are finished. Rethrows the first exception
+    // thrown by a task.
+    void Wait()
+    {
+        auto& worker = detail::CurrentWorker();
+        auto worker0 = worker;
+        worker = { this, 0 };
+
+        while (pending_ > 0)
+        {
+            if (!RunTask(0))
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return pending_ == 0 || queued_ > 0; });
+            }
+        }
+
+        worker = worker0;
+
+        if (error_)
+        {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool PopTask(std::size_t i, std::function<void()>& task)
+    {
+        // own queue from the back, other queues from the front
+        for (std::size_t k{0}; k < queues_.size(); ++k)
+        {
+            auto& queue = *queues_[(i + k) % queues_.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+
+            if (queue.tasks.empty()) continue;
+
+            if (k == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool RunTask(std::size_t i)
+    {
+        std::function<void()> task;
+        if (!PopTask(i, task)) return false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --queued_;
+        }
+
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+
+        if (--pending_ == 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+
+        return true;
+    }
+
+    void WorkerLoop(std::size_t i)
+    {
+        detail::CurrentWorker() = { this, i };
+
+        for (;;)
+        {
+            if (RunTask(i)) continue;
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stop_ || queued_ > 0; });
+            if (stop_) return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<std::size_t> pending_;
+    std::size_t queued_;
+    std::atomic<std::size_t> next_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_;
+    std::exception_ptr error_;
+};
+
+// Call f(begin, end) for consecutive ranges partitioning [0, n) in
+// parallel and wait for all of them to finish.
+template <typename F>
+void
+ParallelFor(ThreadPool& pool, std::size_t n, F f)
+{
+    auto nchunks = std::min(n, 4 * pool.NumThreads());
+    for (std::size_t c{0}; c < nchunks; ++c)
+    {
+        auto begin = n * c / nchunks;
+        auto end = n * (c + 1) / nchunks;
+        pool.Submit([=] { f(begin, end); });
+    }
+
+    pool.Wait();
+}
+
+} // namespace zorder_knn
+
+#endif // ZORDER_KNN_THREAD_POOL_HPP